@@ -0,0 +1,109 @@
+#include "alloc_counter.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <dlfcn.h>
+#include <malloc.h>
+
+namespace OrderEngine {
+namespace {
+
+std::atomic<uint64_t> g_allocations{0};
+std::atomic<uint64_t> g_frees{0};
+std::atomic<uint64_t> g_bytes{0};
+std::atomic<uint64_t> g_footprint{0};
+thread_local AllocationCounts t_counts;
+
+// glibc keeps one size_t of header in front of each chunk
+uint64_t chunkBytes(void* ptr) {
+    return malloc_usable_size(ptr) + sizeof(std::size_t);
+}
+
+void* countedAlloc(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+    t_counts.allocations++;
+    t_counts.bytes += size;
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    g_footprint.fetch_add(chunkBytes(ptr), std::memory_order_relaxed);
+    return ptr;
+}
+
+void* countedAlignedAlloc(std::size_t size, std::align_val_t alignment) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+    t_counts.allocations++;
+    t_counts.bytes += size;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    void* ptr = std::aligned_alloc(align, (size + align - 1) / align * align);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    g_footprint.fetch_add(chunkBytes(ptr), std::memory_order_relaxed);
+    return ptr;
+}
+
+void countedFree(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+    g_frees.fetch_add(1, std::memory_order_relaxed);
+    g_footprint.fetch_sub(chunkBytes(ptr), std::memory_order_relaxed);
+    t_counts.frees++;
+    std::free(ptr);
+}
+
+} // namespace
+
+AllocationCounts threadAllocationCounts() {
+    return t_counts;
+}
+
+AllocationCounts processAllocationCounts() {
+    return {g_allocations.load(std::memory_order_relaxed),
+            g_frees.load(std::memory_order_relaxed),
+            g_bytes.load(std::memory_order_relaxed)};
+}
+
+uint64_t processHeapFootprint() {
+    return g_footprint.load(std::memory_order_relaxed);
+}
+
+bool shimThreadAllocationCounts(AllocationCounts& counts) {
+    using ShimCountsFn = void (*)(uint64_t*, uint64_t*, uint64_t*);
+    static auto shim_counts = reinterpret_cast<ShimCountsFn>(dlsym(RTLD_DEFAULT, "oe_shim_thread_counts"));
+    if (!shim_counts) {
+        return false;
+    }
+    shim_counts(&counts.allocations, &counts.frees, &counts.bytes);
+    return true;
+}
+
+} // namespace OrderEngine
+
+// Replaceable global allocation functions
+void* operator new(std::size_t size) { return OrderEngine::countedAlloc(size); }
+void* operator new[](std::size_t size) { return OrderEngine::countedAlloc(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try { return OrderEngine::countedAlloc(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try { return OrderEngine::countedAlloc(size); } catch (...) { return nullptr; }
+}
+void operator delete(void* ptr) noexcept { OrderEngine::countedFree(ptr); }
+void operator delete[](void* ptr) noexcept { OrderEngine::countedFree(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { OrderEngine::countedFree(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { OrderEngine::countedFree(ptr); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return OrderEngine::countedAlignedAlloc(size, alignment);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return OrderEngine::countedAlignedAlloc(size, alignment);
+}
+void operator delete(void* ptr, std::align_val_t) noexcept { OrderEngine::countedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { OrderEngine::countedFree(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { OrderEngine::countedFree(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { OrderEngine::countedFree(ptr); }
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+namespace OrderEngine {
+
+// Heap traffic seen through the replaced global operator new/delete.
+// Linking alloc_counter.cpp into a binary turns counting on.
+struct AllocationCounts {
+    uint64_t allocations{0};
+    uint64_t frees{0};
+    uint64_t bytes{0};
+    
+    AllocationCounts operator-(const AllocationCounts& other) const {
+        return {allocations - other.allocations, frees - other.frees, bytes - other.bytes};
+    }
+};
+
+AllocationCounts threadAllocationCounts();   // Calling thread only
+AllocationCounts processAllocationCounts();  // All threads
+
+// Live heap bytes as the allocator sees them (usable size plus chunk header),
+// so the difference from requested bytes is allocator rounding and overhead
+uint64_t processHeapFootprint();
+
+// Counts from the LD_PRELOAD malloc shim (libc-level malloc/free on the calling
+// thread). Returns false if the shim is not preloaded.
+bool shimThreadAllocationCounts(AllocationCounts& counts);
+
+} // namespace OrderEngine
@@ -0,0 +1,234 @@
+// Compares two sets of benchmark runs written with --format=json/--out=FILE.
+// Each file may hold several runs of the same benchmarks (append with repeated
+// --out runs); results are grouped by suite, benchmark and params.
+//
+// For p50, p99 and throughput the medians of both sides are compared, with a
+// 95% bootstrap confidence interval on the relative change. A benchmark is a
+// regression when the change is worse than the threshold and the interval
+// excludes zero; with a single run per side the interval is just the point.
+//
+//   ./bench_compare BASELINE.jsonl CANDIDATE.jsonl [--threshold=PCT] [--metrics=p50,p99,throughput]
+//   Exit status: 0 no regressions, 1 regressions found, 2 usage or input error.
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "bench_report.hpp"
+
+using namespace OrderEngine;
+
+namespace {
+
+struct Metric {
+    std::string name;
+    bool higher_is_better;
+    double (*value)(const BenchResult&);
+};
+
+const std::vector<Metric> kMetrics = {
+    {"p50", false, [](const BenchResult& r) { return static_cast<double>(r.p50_ns); }},
+    {"p99", false, [](const BenchResult& r) { return static_cast<double>(r.p99_ns); }},
+    {"throughput", true, [](const BenchResult& r) { return r.opsPerSec(); }},
+};
+
+struct RunSet {
+    std::map<std::string, std::vector<BenchResult>> results;  // By benchmark key
+    std::set<std::string> commits;
+    std::set<std::string> setups;  // Compiler, flags and CPU
+};
+
+std::string resultKey(const BenchResult& result) {
+    std::string key = result.suite + "/" + result.name;
+    for (const auto& [name, value] : result.params) {
+        key += " " + name + "=" + value;
+    }
+    return key;
+}
+
+bool loadRuns(const std::string& path, RunSet& runs) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Cannot open " << path << "\n";
+        return false;
+    }
+    std::string line;
+    BenchResult result;
+    BenchEnvironment env;
+    while (std::getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        if (!parseBenchJson(line, result, env)) {
+            std::cerr << path << ": skipping unreadable line\n";
+            continue;
+        }
+        runs.commits.insert(env.commit);
+        runs.setups.insert(env.compiler + " | " + env.flags + " | " + env.cpu_model);
+        runs.results[resultKey(result)].push_back(result);
+    }
+    return true;
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    size_t mid = values.size() / 2;
+    return values.size() % 2 ? values[mid] : (values[mid - 1] + values[mid]) / 2.0;
+}
+
+// Relative change of the candidate median over the baseline median, with a
+// percentile-bootstrap 95% interval. Seeded so reruns print the same numbers.
+struct Change {
+    double point;
+    double low;
+    double high;
+};
+
+Change medianChange(const std::vector<double>& base, const std::vector<double>& cand) {
+    double base_median = median(base);
+    Change change{median(cand) / base_median - 1.0, 0.0, 0.0};
+    if (base.size() < 2 && cand.size() < 2) {
+        change.low = change.high = change.point;
+        return change;
+    }
+    
+    constexpr int kResamples = 2000;
+    std::mt19937_64 rng(1);
+    std::vector<double> ratios;
+    ratios.reserve(kResamples);
+    std::vector<double> base_sample(base.size());
+    std::vector<double> cand_sample(cand.size());
+    std::uniform_int_distribution<size_t> pick_base(0, base.size() - 1);
+    std::uniform_int_distribution<size_t> pick_cand(0, cand.size() - 1);
+    for (int i = 0; i < kResamples; ++i) {
+        for (auto& value : base_sample) value = base[pick_base(rng)];
+        for (auto& value : cand_sample) value = cand[pick_cand(rng)];
+        double resampled_base = median(base_sample);
+        if (resampled_base > 0) {
+            ratios.push_back(median(cand_sample) / resampled_base - 1.0);
+        }
+    }
+    std::sort(ratios.begin(), ratios.end());
+    change.low = ratios[static_cast<size_t>(0.025 * (ratios.size() - 1))];
+    change.high = ratios[static_cast<size_t>(0.975 * (ratios.size() - 1))];
+    return change;
+}
+
+void printSetup(const std::string& label, const RunSet& runs) {
+    std::cout << label << ": commit";
+    for (const auto& commit : runs.commits) std::cout << " " << commit;
+    std::cout << "\n";
+    for (const auto& setup : runs.setups) std::cout << "  " << setup << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> paths;
+    double threshold = 0.05;
+    std::set<std::string> metrics = {"p50", "p99", "throughput"};
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--threshold=", 0) == 0) {
+            threshold = std::stod(arg.substr(12)) / 100.0;
+        } else if (arg.rfind("--metrics=", 0) == 0) {
+            metrics.clear();
+            std::stringstream list(arg.substr(10));
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                metrics.insert(item);
+            }
+        } else if (arg.rfind("--", 0) != 0) {
+            paths.push_back(arg);
+        } else {
+            paths.clear();
+            break;
+        }
+    }
+    if (paths.size() != 2) {
+        std::cerr << "Usage: " << argv[0] << " BASELINE.jsonl CANDIDATE.jsonl"
+                  << " [--threshold=PCT] [--metrics=p50,p99,throughput]\n";
+        return 2;
+    }
+    
+    RunSet baseline, candidate;
+    if (!loadRuns(paths[0], baseline) || !loadRuns(paths[1], candidate)) {
+        return 2;
+    }
+    printSetup("baseline", baseline);
+    printSetup("candidate", candidate);
+    if (baseline.setups != candidate.setups) {
+        std::cout << "WARNING: compiler, flags or CPU differ between the two sides\n";
+    }
+    size_t key_width = 12;
+    for (const auto& entry : baseline.results) {
+        key_width = std::max(key_width, entry.first.size() + 2);
+    }
+    std::cout << "\n" << std::left << std::setw(key_width) << "benchmark" << std::setw(12) << "metric"
+              << std::right << std::setw(8) << "runs" << std::setw(14) << "baseline"
+              << std::setw(14) << "candidate" << std::setw(10) << "change"
+              << std::setw(22) << "95% CI" << "  status\n";
+    
+    size_t regressions = 0;
+    size_t compared = 0;
+    for (const auto& [key, base_results] : baseline.results) {
+        auto found = candidate.results.find(key);
+        if (found == candidate.results.end()) {
+            continue;
+        }
+        const auto& cand_results = found->second;
+        for (const auto& metric : kMetrics) {
+            if (!metrics.count(metric.name)) {
+                continue;
+            }
+            std::vector<double> base, cand;
+            for (const auto& r : base_results) base.push_back(metric.value(r));
+            for (const auto& r : cand_results) cand.push_back(metric.value(r));
+            if (median(base) <= 0) {
+                continue;
+            }
+            
+            Change change = medianChange(base, cand);
+            // Positive "worse" means slower: higher latency or lower throughput
+            double sign = metric.higher_is_better ? -1.0 : 1.0;
+            double worse = sign * change.point;
+            double worse_low = std::min(sign * change.low, sign * change.high);
+            double worse_high = std::max(sign * change.low, sign * change.high);
+            const char* status = "ok";
+            if (worse > threshold && worse_low > 0) {
+                status = "REGRESSION";
+                regressions++;
+            } else if (worse < -threshold && worse_high < 0) {
+                status = "improved";
+            } else if (std::abs(worse) > threshold) {
+                status = "noise";
+            }
+            compared++;
+            
+            std::ostringstream runs, interval;
+            runs << base.size() << "/" << cand.size();
+            interval << std::fixed << std::setprecision(1) << "[" << change.low * 100 << "%, "
+                     << change.high * 100 << "%]";
+            std::cout << std::left << std::setw(key_width) << key << std::setw(12) << metric.name
+                      << std::right << std::setw(8) << runs.str()
+                      << std::fixed << std::setprecision(1)
+                      << std::setw(14) << median(base) << std::setw(14) << median(cand)
+                      << std::setw(9) << change.point * 100 << "%"
+                      << std::setw(22) << interval.str() << "  " << status << "\n";
+        }
+    }
+    
+    std::cout << "\n" << compared << " comparisons, " << regressions << " regressions above "
+              << threshold * 100 << "%\n";
+    if (compared == 0) {
+        std::cerr << "No benchmarks in common\n";
+        return 2;
+    }
+    return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,317 @@
+#include "bench_report.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace OrderEngine {
+
+void BenchResult::setPercentiles(const LatencyHistogram& histogram) {
+    p50_ns = histogram.getPercentile(50.0);
+    p90_ns = histogram.getPercentile(90.0);
+    p99_ns = histogram.getPercentile(99.0);
+    p999_ns = histogram.getPercentile(99.9);
+    max_ns = histogram.getMax();
+}
+
+#ifndef OE_GIT_COMMIT
+#define OE_GIT_COMMIT "unknown"
+#endif
+#ifndef OE_CXX_FLAGS
+#define OE_CXX_FLAGS ""
+#endif
+
+namespace {
+
+std::string cpuModel() {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.rfind("model name", 0) == 0) {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                return line.substr(line.find_first_not_of(" \t", colon + 1));
+            }
+        }
+    }
+    return "unknown";
+}
+
+std::string compilerId() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#else
+    return "unknown";
+#endif
+}
+
+// Just enough JSON to read back what writeJson produces: one object of
+// strings and numbers, with nested objects of string values
+class JsonCursor {
+public:
+    explicit JsonCursor(const std::string& text) : text_(text) {}
+    
+    bool consume(char c) {
+        skipSpace();
+        if (pos_ < text_.size() && text_[pos_] == c) {
+            pos_++;
+            return true;
+        }
+        return false;
+    }
+    
+    bool peek(char c) {
+        skipSpace();
+        return pos_ < text_.size() && text_[pos_] == c;
+    }
+    
+    bool readString(std::string& out) {
+        if (!consume('"')) {
+            return false;
+        }
+        out.clear();
+        while (pos_ < text_.size() && text_[pos_] != '"') {
+            char c = text_[pos_++];
+            if (c == '\\' && pos_ < text_.size()) {
+                c = text_[pos_++];
+                if (c == 'u' && pos_ + 4 <= text_.size()) {
+                    c = static_cast<char>(std::strtol(text_.substr(pos_, 4).c_str(), nullptr, 16));
+                    pos_ += 4;
+                } else if (c == 'n') {
+                    c = '\n';
+                } else if (c == 't') {
+                    c = '\t';
+                }
+            }
+            out += c;
+        }
+        return consume('"');
+    }
+    
+    bool readNumber(double& out) {
+        skipSpace();
+        const char* start = text_.c_str() + pos_;
+        char* end = nullptr;
+        out = std::strtod(start, &end);
+        if (end == start) {
+            return false;
+        }
+        pos_ += static_cast<size_t>(end - start);
+        return true;
+    }
+    
+    bool readStringMap(std::vector<std::pair<std::string, std::string>>& out) {
+        if (!consume('{')) {
+            return false;
+        }
+        while (!consume('}')) {
+            std::string key, value;
+            if (!readString(key) || !consume(':') || !readString(value)) {
+                return false;
+            }
+            out.emplace_back(std::move(key), std::move(value));
+            consume(',');
+        }
+        return true;
+    }
+    
+private:
+    void skipSpace() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+            pos_++;
+        }
+    }
+    
+    const std::string& text_;
+    size_t pos_{0};
+};
+
+} // namespace
+
+const BenchEnvironment& BenchEnvironment::current() {
+    static const BenchEnvironment env{OE_GIT_COMMIT, compilerId(), OE_CXX_FLAGS, cpuModel()};
+    return env;
+}
+
+std::string jsonEscape(const std::string& value) {
+    std::string escaped;
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+            escaped += buffer;
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+void BenchReporter::writeJson(std::ostream& out) const {
+    const BenchEnvironment& env = BenchEnvironment::current();
+    for (const auto& r : results_) {
+        out << "{\"suite\":\"" << jsonEscape(r.suite) << "\",\"benchmark\":\"" << jsonEscape(r.name) << "\"";
+        out << ",\"params\":{";
+        for (size_t i = 0; i < r.params.size(); ++i) {
+            out << (i ? "," : "") << "\"" << jsonEscape(r.params[i].first) << "\":\""
+                << jsonEscape(r.params[i].second) << "\"";
+        }
+        out << "}";
+        out << ",\"ops\":" << r.ops
+            << ",\"total_ns\":" << r.total_ns
+            << std::fixed << std::setprecision(3)
+            << ",\"ns_per_op\":" << r.nsPerOp()
+            << ",\"ops_per_sec\":" << r.opsPerSec()
+            << ",\"p50_ns\":" << r.p50_ns
+            << ",\"p90_ns\":" << r.p90_ns
+            << ",\"p99_ns\":" << r.p99_ns
+            << ",\"p999_ns\":" << r.p999_ns
+            << ",\"max_ns\":" << r.max_ns;
+        for (const auto& value : r.extra) {
+            // JSON has no NaN or infinity, e.g. a rate over an empty run
+            if (std::isfinite(value.second)) {
+                out << ",\"" << jsonEscape(value.first) << "\":" << value.second;
+            }
+        }
+        out << ",\"env\":{\"commit\":\"" << jsonEscape(env.commit)
+            << "\",\"compiler\":\"" << jsonEscape(env.compiler)
+            << "\",\"flags\":\"" << jsonEscape(env.flags)
+            << "\",\"cpu\":\"" << jsonEscape(env.cpu_model) << "\"}";
+        out << "}\n";
+    }
+}
+
+void BenchReporter::writeTable(std::ostream& out) const {
+    // The params column is as wide as the longest row's, so every column lines up
+    std::vector<std::string> params(results_.size());
+    size_t params_width = 32;
+    for (size_t row = 0; row < results_.size(); ++row) {
+        for (const auto& [key, value] : results_[row].params) {
+            params[row] += (params[row].empty() ? "" : " ") + key + "=" + value;
+        }
+        params_width = std::max(params_width, params[row].size() + 1);
+    }
+    out << std::left << std::setw(20) << "benchmark" << std::setw(static_cast<int>(params_width)) << "params"
+        << std::right << std::setw(12) << "ops" << std::setw(11) << "ns/op" << std::setw(10) << "p50"
+        << std::setw(10) << "p99" << std::setw(10) << "p99.9" << std::setw(12) << "max" << "\n";
+    for (size_t row = 0; row < results_.size(); ++row) {
+        const BenchResult& r = results_[row];
+        out << std::left << std::setw(20) << r.name << std::setw(static_cast<int>(params_width)) << params[row]
+            << std::right
+            << std::setw(12) << r.ops
+            << std::setw(11) << std::fixed << std::setprecision(1) << r.nsPerOp()
+            << std::setw(10) << r.p50_ns << std::setw(10) << r.p99_ns
+            << std::setw(10) << r.p999_ns << std::setw(12) << r.max_ns;
+        for (const auto& [key, value] : r.extra) {
+            out << "  " << key << "=" << std::defaultfloat << std::setprecision(4) << value;
+        }
+        out << "\n";
+    }
+}
+
+bool BenchOutputOptions::parse(const std::string& arg) {
+    if (arg == "--format=json") {
+        json = true;
+    } else if (arg == "--format=table") {
+        json = false;
+    } else if (arg.rfind("--out=", 0) == 0) {
+        out_path = arg.substr(6);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool BenchOutputOptions::write(const BenchReporter& reporter) const {
+    if (out_path.empty()) {
+        if (json) {
+            reporter.writeJson(std::cout);
+        } else {
+            reporter.writeTable(std::cout);
+        }
+        return static_cast<bool>(std::cout);
+    }
+    
+    // Files are always JSON Lines, appended so repeated runs accumulate
+    std::ofstream file(out_path, std::ios::app);
+    if (!file) {
+        std::cerr << "Cannot open " << out_path << "\n";
+        return false;
+    }
+    reporter.writeJson(file);
+    if (!json) {
+        reporter.writeTable(std::cout);
+    }
+    return static_cast<bool>(file);
+}
+
+bool parseBenchJson(const std::string& line, BenchResult& result, BenchEnvironment& env) {
+    JsonCursor json(line);
+    if (!json.consume('{')) {
+        return false;
+    }
+    result = BenchResult{};
+    env = BenchEnvironment{};
+    bool has_name = false;
+    while (!json.consume('}')) {
+        std::string key;
+        if (!json.readString(key) || !json.consume(':')) {
+            return false;
+        }
+        if (key == "params" || key == "env") {
+            std::vector<std::pair<std::string, std::string>> values;
+            if (!json.readStringMap(values)) {
+                return false;
+            }
+            if (key == "params") {
+                result.params = std::move(values);
+            } else {
+                for (const auto& [name, value] : values) {
+                    if (name == "commit") env.commit = value;
+                    else if (name == "compiler") env.compiler = value;
+                    else if (name == "flags") env.flags = value;
+                    else if (name == "cpu") env.cpu_model = value;
+                }
+            }
+        } else if (json.peek('"')) {
+            std::string value;
+            if (!json.readString(value)) {
+                return false;
+            }
+            if (key == "suite") {
+                result.suite = value;
+            } else if (key == "benchmark") {
+                result.name = value;
+                has_name = true;
+            }
+        } else {
+            double value;
+            if (!json.readNumber(value)) {
+                return false;
+            }
+            // ns_per_op and ops_per_sec are derived from ops and total_ns
+            if (key == "ops") result.ops = static_cast<uint64_t>(value);
+            else if (key == "total_ns") result.total_ns = static_cast<uint64_t>(value);
+            else if (key == "p50_ns") result.p50_ns = static_cast<uint64_t>(value);
+            else if (key == "p90_ns") result.p90_ns = static_cast<uint64_t>(value);
+            else if (key == "p99_ns") result.p99_ns = static_cast<uint64_t>(value);
+            else if (key == "p999_ns") result.p999_ns = static_cast<uint64_t>(value);
+            else if (key == "max_ns") result.max_ns = static_cast<uint64_t>(value);
+            else if (key != "ns_per_op" && key != "ops_per_sec") result.extra.emplace_back(key, value);
+        }
+        json.consume(',');
+    }
+    return has_name;
+}
+
+} // namespace OrderEngine
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "histogram.hpp"
+
+namespace OrderEngine {
+
+// One benchmark measurement. Written as a single JSON object per line
+// (JSON Lines) so runs can be appended, grepped and compared.
+struct BenchResult {
+    std::string suite;
+    std::string name;
+    std::vector<std::pair<std::string, std::string>> params;
+    uint64_t ops{0};
+    uint64_t total_ns{0};
+    uint64_t p50_ns{0};
+    uint64_t p90_ns{0};
+    uint64_t p99_ns{0};
+    uint64_t p999_ns{0};
+    uint64_t max_ns{0};
+    std::vector<std::pair<std::string, double>> extra;  // Benchmark-specific values
+    
+    double nsPerOp() const { return ops > 0 ? static_cast<double>(total_ns) / ops : 0.0; }
+    double opsPerSec() const { return total_ns > 0 ? ops * 1e9 / total_ns : 0.0; }
+    
+    // Fills the percentile fields from per-operation latencies
+    void setPercentiles(const LatencyHistogram& histogram);
+};
+
+// Where results came from, recorded with every JSON line so that runs from
+// different commits, compilers or machines are never compared blindly.
+// The commit and flags are captured when CMake configures the build.
+struct BenchEnvironment {
+    std::string commit;
+    std::string compiler;
+    std::string flags;
+    std::string cpu_model;
+    
+    static const BenchEnvironment& current();
+};
+
+class BenchReporter {
+public:
+    void add(BenchResult result) { results_.push_back(std::move(result)); }
+    const std::vector<BenchResult>& results() const { return results_; }
+    
+    void writeJson(std::ostream& out) const;
+    void writeTable(std::ostream& out) const;
+    
+private:
+    std::vector<BenchResult> results_;
+};
+
+// Shared command-line handling: --format=table|json and --out=FILE
+struct BenchOutputOptions {
+    bool json{false};
+    std::string out_path;
+    
+    // Consumes the argument if it is an output option
+    bool parse(const std::string& arg);
+    // Writes the results to out_path or stdout; returns false on I/O failure
+    bool write(const BenchReporter& reporter) const;
+};
+
+std::string jsonEscape(const std::string& value);
+
+// Reads back one line written by BenchReporter::writeJson. Returns false if
+// the line is not a benchmark result.
+bool parseBenchJson(const std::string& line, BenchResult& result, BenchEnvironment& env);
+
+} // namespace OrderEngine
@@ -0,0 +1,13 @@
+# Two runs of a small benchmark compared against themselves: no regressions
+file(REMOVE ${OUT})
+foreach(run 1 2)
+    execute_process(COMMAND ${BENCH} --sizes=1000 --ops=200 --format=json --out=${OUT}
+        OUTPUT_QUIET RESULT_VARIABLE status)
+    if(NOT status EQUAL 0)
+        message(FATAL_ERROR "benchmark run ${run} failed")
+    endif()
+endforeach()
+execute_process(COMMAND ${COMPARE} ${OUT} ${OUT} RESULT_VARIABLE status)
+if(NOT status EQUAL 0)
+    message(FATAL_ERROR "bench_compare exited with ${status}")
+endif()
@@ -0,0 +1,123 @@
+// Hot-path hygiene check: counts heap allocations and syscalls per order on the
+// matching path once the book is in steady state, and fails if there are any.
+//
+//   ./order_book_hygiene [--orders=N] [--warmup=N]
+//   LD_PRELOAD=./liboe_malloc_shim.so ./order_book_hygiene   (also counts libc malloc)
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "order_book.hpp"
+#include "alloc_counter.hpp"
+#include "syscall_counter.hpp"
+
+using namespace OrderEngine;
+
+// Orders around a fixed mid so the book stays small and about half the flow crosses
+static std::vector<std::unique_ptr<Order>> makeSteadyStateFlow(size_t count, uint64_t first_id, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> side_dist(0, 1);
+    std::uniform_int_distribution<int> tick_dist(-5, 5);
+    std::uniform_int_distribution<uint32_t> quantity_dist(1, 10);
+    
+    std::vector<std::unique_ptr<Order>> orders;
+    orders.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        OrderSide side = side_dist(rng) ? OrderSide::BUY : OrderSide::SELL;
+        double price = 100.0 + tick_dist(rng) * 0.01;
+        orders.push_back(std::make_unique<Order>(first_id + i, side, price, quantity_dist(rng)));
+    }
+    return orders;
+}
+
+static void printPerOrder(const char* label, const AllocationCounts& counts, size_t orders) {
+    std::cout << "  " << std::left << std::setw(26) << label << std::right << std::fixed << std::setprecision(3)
+              << static_cast<double>(counts.allocations) / orders << " allocs/order, "
+              << static_cast<double>(counts.frees) / orders << " frees/order, "
+              << static_cast<double>(counts.bytes) / orders << " bytes/order\n";
+}
+
+int main(int argc, char* argv[]) {
+    size_t measured_orders = 100000;
+    size_t warmup_orders = 100000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--orders=", 0) == 0) {
+            measured_orders = std::stoull(arg.substr(9));
+        } else if (arg.rfind("--warmup=", 0) == 0) {
+            warmup_orders = std::stoull(arg.substr(9));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--orders=N] [--warmup=N]\n";
+            return 2;
+        }
+    }
+    
+    // Matching path, run synchronously so this thread is the matching thread
+    OrderBook order_book;
+    uint64_t trades = 0;
+    order_book.setTradeCallback([&trades](const Trade&) { trades++; });
+    
+    auto warmup = makeSteadyStateFlow(warmup_orders, 1, 42);
+    auto measured = makeSteadyStateFlow(measured_orders, warmup_orders + 1, 43);
+    for (auto& order : warmup) {
+        order_book.processOrderSync(std::move(order));
+    }
+    
+    SyscallCounter syscalls;
+    AllocationCounts shim_start{}, shim_end{};
+    bool shim_loaded = shimThreadAllocationCounts(shim_start);
+    uint64_t syscalls_start = syscalls.read();
+    AllocationCounts new_start = threadAllocationCounts();
+    
+    for (auto& order : measured) {
+        order_book.processOrderSync(std::move(order));
+    }
+    
+    AllocationCounts new_delta = threadAllocationCounts() - new_start;
+    uint64_t syscall_delta = syscalls.read() - syscalls_start;
+    if (shim_loaded) {
+        shimThreadAllocationCounts(shim_end);
+    }
+    AllocationCounts shim_delta = shim_end - shim_start;
+    
+    // Producer path: what submitting an order costs the caller before matching
+    OrderBook stopped_book;
+    AllocationCounts producer_start = threadAllocationCounts();
+    for (size_t i = 0; i < measured_orders; ++i) {
+        stopped_book.submitOrder(std::make_unique<Order>(i + 1, OrderSide::BUY, 100.0, 1));
+    }
+    AllocationCounts producer_delta = threadAllocationCounts() - producer_start;
+    
+    std::cout << "=== HOT PATH HYGIENE ===\n";
+    std::cout << "Steady state: " << measured_orders << " orders after " << warmup_orders
+              << " warm-up | trades " << trades
+              << " | resting " << order_book.getBuyOrdersCount() + order_book.getSellOrdersCount() << "\n";
+    std::cout << "Matching path:\n";
+    printPerOrder("operator new/delete:", new_delta, measured_orders);
+    if (shim_loaded) {
+        printPerOrder("libc malloc/free (shim):", shim_delta, measured_orders);
+    } else {
+        std::cout << "  " << std::left << std::setw(26) << "libc malloc/free (shim):" << std::right
+                  << "not preloaded\n";
+    }
+    std::cout << "  " << std::left << std::setw(26) << "syscalls:" << std::right << std::setprecision(3)
+              << static_cast<double>(syscall_delta) / measured_orders << "/order ("
+              << syscall_delta << " total, " << syscalls.source() << ")\n";
+    std::cout << "Producer path (make_unique + submitOrder):\n";
+    printPerOrder("operator new/delete:", producer_delta, measured_orders);
+    
+    bool allocates = new_delta.allocations > 0 || new_delta.frees > 0 ||
+                     shim_delta.allocations > 0 || shim_delta.frees > 0;
+    bool makes_syscalls = syscall_delta > 0;
+    if (allocates || makes_syscalls) {
+        std::cout << "RESULT: FAIL (matching path"
+                  << (allocates ? " touches the heap" : "")
+                  << (allocates && makes_syscalls ? " and" : "")
+                  << (makes_syscalls ? " makes syscalls" : "") << ")\n";
+        return 1;
+    }
+    std::cout << "RESULT: PASS\n";
+    return 0;
+}
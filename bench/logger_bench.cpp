@@ -0,0 +1,206 @@
+// TradeLogger throughput and tail latency. Trades are pushed through logTrade
+// at a configured rate in bursts of a configured size, into a file in each of
+// the given directories (tmpfs and real disk, for a fair comparison).
+//
+// Reported per directory/rate/burst:
+//   log_trade         producer-side latency of logTrade()
+//   enqueue_to_write  logTrade() until the line is written and flushed to the
+//                     kernel (page cache; the logger does not fsync)
+// with sustained written bytes/sec and the peak and end-of-run queue depth.
+//
+//   ./logger_bench [--dirs=/dev/shm,.] [--rates=100000,0] [--bursts=1,100]
+//                  [--trades=N] [--format=table|json] [--out=FILE]
+//   A rate of 0 sends as fast as logTrade() allows.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/vfs.h>
+#include "logger.hpp"
+#include "bench_report.hpp"
+
+using namespace OrderEngine;
+
+namespace {
+
+// Trade timestamps use this clock, so the whole bench does
+using Clock = std::chrono::high_resolution_clock;
+
+constexpr long kTmpfsMagic = 0x01021994;
+
+uint64_t elapsedNs(Clock::time_point start, Clock::time_point end) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        items.push_back(item);
+    }
+    return items;
+}
+
+std::string filesystemKind(const std::string& dir) {
+    struct statfs fs{};
+    if (statfs(dir.c_str(), &fs) != 0) {
+        return "unknown";
+    }
+    return static_cast<long>(fs.f_type) == kTmpfsMagic ? "tmpfs" : "disk";
+}
+
+struct RunConfig {
+    std::string dir;
+    double rate;   // Trades/sec, 0 = unpaced
+    size_t burst;  // Trades sent back to back per burst
+    size_t trades;
+};
+
+void runConfig(const RunConfig& config, BenchReporter& reporter) {
+    std::string path = config.dir + "/oe_logger_bench.csv";
+    LatencyHistogram producer;
+    LatencyHistogram written;  // Recorded on the logging thread, read after stop()
+    uint64_t producer_total_ns = 0;
+    uint64_t bytes = 0;
+    Clock::time_point last_write;
+    
+    size_t end_depth = 0;
+    std::atomic<size_t> max_depth{0};
+    Clock::time_point first_enqueue;
+    Clock::time_point last_enqueue;
+    {
+        TradeLogger logger(path);
+        logger.setWrittenCallback([&](const Trade& trade, size_t line_bytes) {
+            last_write = Clock::now();
+            written.record(elapsedNs(trade.timestamp, last_write));
+            bytes += line_bytes;
+        });
+        logger.start();
+        
+        std::atomic<bool> monitoring{true};
+        std::thread monitor([&] {
+            while (monitoring) {
+                max_depth = std::max(max_depth.load(), logger.getQueueDepth());
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+            }
+        });
+        
+        auto burst_interval = std::chrono::nanoseconds(
+            config.rate > 0 ? static_cast<int64_t>(1e9 * config.burst / config.rate) : 0);
+        first_enqueue = Clock::now();
+        auto next_burst = first_enqueue;
+        for (size_t sent = 0; sent < config.trades; ) {
+            while (Clock::now() < next_burst) {
+                if (next_burst - Clock::now() > std::chrono::microseconds(200)) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+            }
+            next_burst += burst_interval;
+            for (size_t i = 0; i < config.burst && sent < config.trades; ++i, ++sent) {
+                Trade trade{2 * sent + 1, 2 * sent + 2, 100.0 + (sent % 500) * 0.01,
+                            static_cast<uint32_t>(1 + sent % 100), Clock::now()};
+                logger.logTrade(trade);
+                uint64_t ns = elapsedNs(trade.timestamp, Clock::now());
+                producer.record(ns);
+                producer_total_ns += ns;
+            }
+        }
+        last_enqueue = Clock::now();
+        end_depth = logger.getQueueDepth();
+        
+        logger.stop();  // Drains the queue
+        monitoring = false;
+        monitor.join();
+    }
+    std::remove(path.c_str());
+    
+    double send_s = elapsedNs(first_enqueue, last_enqueue) / 1e9;
+    double write_s = elapsedNs(first_enqueue, last_write) / 1e9;
+    auto describe = [&](BenchResult& result) {
+        result.suite = "logger";
+        result.params = {{"fs", filesystemKind(config.dir)},
+                         {"rate", config.rate > 0 ? std::to_string(static_cast<uint64_t>(config.rate)) : "max"},
+                         {"burst", std::to_string(config.burst)}};
+        result.ops = config.trades;
+    };
+    
+    BenchResult enqueue;
+    describe(enqueue);
+    enqueue.name = "log_trade";
+    enqueue.total_ns = producer_total_ns;
+    enqueue.setPercentiles(producer);
+    enqueue.extra = {{"offered_per_sec", send_s > 0 ? config.trades / send_s : 0.0}};
+    reporter.add(std::move(enqueue));
+    
+    BenchResult write;
+    describe(write);
+    write.name = "enqueue_to_write";
+    write.total_ns = elapsedNs(first_enqueue, last_write);
+    write.setPercentiles(written);
+    write.extra = {{"bytes_per_sec", write_s > 0 ? bytes / write_s : 0.0},
+                   {"max_queue_depth", static_cast<double>(max_depth.load())},
+                   {"end_queue_depth", static_cast<double>(end_depth)},
+                   {"drain_ms", elapsedNs(last_enqueue, last_write) / 1e6}};
+    reporter.add(std::move(write));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> dirs = {"/dev/shm", "."};
+    std::vector<double> rates = {100000, 0};
+    std::vector<size_t> bursts = {1, 100};
+    size_t trades = 200000;
+    BenchOutputOptions output;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (output.parse(arg)) {
+                continue;
+            } else if (arg.rfind("--dirs=", 0) == 0) {
+                dirs = splitList(arg.substr(7));
+            } else if (arg.rfind("--rates=", 0) == 0) {
+                rates.clear();
+                for (const auto& item : splitList(arg.substr(8))) {
+                    rates.push_back(std::stod(item));
+                }
+            } else if (arg.rfind("--bursts=", 0) == 0) {
+                bursts.clear();
+                for (const auto& item : splitList(arg.substr(9))) {
+                    bursts.push_back(std::max<size_t>(std::stoull(item), 1));
+                }
+            } else if (arg.rfind("--trades=", 0) == 0) {
+                trades = std::stoull(arg.substr(9));
+                if (trades == 0) {
+                    throw std::invalid_argument(arg);  // Nothing written: no write or drain times
+                }
+            } else {
+                throw std::invalid_argument(arg);
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Usage: " << argv[0] << " [--dirs=DIR,...] [--rates=N,...] [--bursts=N,...]"
+                  << " [--trades=N] [--format=table|json] [--out=FILE]\n";
+        return 2;
+    }
+    
+    BenchReporter reporter;
+    for (const auto& dir : dirs) {
+        if (filesystemKind(dir) == "unknown") {
+            std::cerr << "Skipping " << dir << ": not accessible\n";
+            continue;
+        }
+        for (double rate : rates) {
+            for (size_t burst : bursts) {
+                runConfig({dir, rate, burst, trades}, reporter);
+            }
+        }
+    }
+    return output.write(reporter) ? 0 : 1;
+}
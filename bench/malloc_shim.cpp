@@ -0,0 +1,124 @@
+// LD_PRELOAD shim counting libc malloc/free per thread. Catches heap traffic
+// that bypasses operator new (C libraries, libstdc++ internals, the runtime).
+//   LD_PRELOAD=./liboe_malloc_shim.so ./order_book_hygiene
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <dlfcn.h>
+
+namespace {
+
+using MallocFn = void* (*)(size_t);
+using FreeFn = void (*)(void*);
+using CallocFn = void* (*)(size_t, size_t);
+using ReallocFn = void* (*)(void*, size_t);
+
+MallocFn real_malloc = nullptr;
+FreeFn real_free = nullptr;
+CallocFn real_calloc = nullptr;
+ReallocFn real_realloc = nullptr;
+
+// dlsym() may allocate while we are still resolving the real functions
+alignas(16) char bootstrap_arena[4096];
+size_t bootstrap_used = 0;
+bool resolving = false;
+
+struct ThreadCounts {
+    uint64_t allocations;
+    uint64_t frees;
+    uint64_t bytes;
+};
+__attribute__((tls_model("initial-exec"))) thread_local ThreadCounts t_counts = {0, 0, 0};
+
+void resolve() {
+    resolving = true;
+    real_malloc = reinterpret_cast<MallocFn>(dlsym(RTLD_NEXT, "malloc"));
+    real_free = reinterpret_cast<FreeFn>(dlsym(RTLD_NEXT, "free"));
+    real_calloc = reinterpret_cast<CallocFn>(dlsym(RTLD_NEXT, "calloc"));
+    real_realloc = reinterpret_cast<ReallocFn>(dlsym(RTLD_NEXT, "realloc"));
+    resolving = false;
+}
+
+void* bootstrapAlloc(size_t size) {
+    size = (size + 15) & ~static_cast<size_t>(15);
+    if (bootstrap_used + size > sizeof(bootstrap_arena)) {
+        return nullptr;
+    }
+    void* ptr = bootstrap_arena + bootstrap_used;
+    bootstrap_used += size;
+    return ptr;
+}
+
+bool isBootstrap(void* ptr) {
+    return ptr >= bootstrap_arena && ptr < bootstrap_arena + sizeof(bootstrap_arena);
+}
+
+} // namespace
+
+extern "C" {
+
+void* malloc(size_t size) {
+    if (!real_malloc) {
+        if (resolving) {
+            return bootstrapAlloc(size);
+        }
+        resolve();
+    }
+    t_counts.allocations++;
+    t_counts.bytes += size;
+    return real_malloc(size);
+}
+
+void free(void* ptr) {
+    if (!ptr || isBootstrap(ptr)) {
+        return;
+    }
+    if (!real_free) {
+        resolve();
+    }
+    t_counts.frees++;
+    real_free(ptr);
+}
+
+void* calloc(size_t count, size_t size) {
+    if (!real_calloc) {
+        if (resolving) {
+            void* ptr = bootstrapAlloc(count * size);
+            if (ptr) {
+                std::memset(ptr, 0, count * size);
+            }
+            return ptr;
+        }
+        resolve();
+    }
+    t_counts.allocations++;
+    t_counts.bytes += count * size;
+    return real_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    if (!real_realloc) {
+        resolve();
+    }
+    if (isBootstrap(ptr)) {
+        void* moved = malloc(size);
+        size_t available = static_cast<size_t>(bootstrap_arena + sizeof(bootstrap_arena) - static_cast<char*>(ptr));
+        if (moved) {
+            std::memcpy(moved, ptr, size < available ? size : available);
+        }
+        return moved;
+    }
+    t_counts.allocations++;
+    t_counts.bytes += size;
+    return real_realloc(ptr, size);
+}
+
+// Looked up with dlsym(RTLD_DEFAULT) by the benchmark binaries
+__attribute__((visibility("default")))
+void oe_shim_thread_counts(uint64_t* allocations, uint64_t* frees, uint64_t* bytes) {
+    *allocations = t_counts.allocations;
+    *frees = t_counts.frees;
+    *bytes = t_counts.bytes;
+}
+
+} // extern "C"
@@ -0,0 +1,229 @@
+// Memory footprint of resting orders. Each book size is loaded in a fresh
+// child process with non-crossing orders spread over --levels price levels per
+// side, and reports RSS growth plus the heap broken down by component through
+// the counting operator new (alloc_counter.cpp):
+//
+//   entry          the order's id and quantity in its level's arrays
+//   level_node     price-map nodes (level header and tree links), amortised
+//                  over the orders at each level
+//   index_node     id -> side and price hash nodes used by cancels
+//   other          the live hash bucket array, spare capacity in the level
+//                  arrays and anything else the book holds
+//   book           the empty book's own allocations, amortised over the orders
+//   allocator      malloc rounding and chunk headers on the node allocations
+//
+//   ./order_book_memory [--orders=1000000,10000000,50000000] [--levels=N]
+//                       [--format=table|json] [--out=FILE]
+// Sizes that would not fit in MemAvailable (extrapolated from the smaller runs) are skipped.
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <utility>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "order_book.hpp"
+#include "alloc_counter.hpp"
+#include "bench_report.hpp"
+
+using namespace OrderEngine;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t readProcKb(const std::string& path, const std::string& field) {
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind(field, 0) == 0) {
+            return std::stoull(line.substr(field.size()));
+        }
+    }
+    return 0;
+}
+
+uint64_t rssBytes() { return readProcKb("/proc/self/status", "VmRSS:") * 1024; }
+uint64_t availableBytes() { return readProcKb("/proc/meminfo", "MemAvailable:") * 1024; }
+
+// Requested bytes allocated by body(), e.g. one node of a container like the
+// book's, so the numbers follow the standard library in use
+uint64_t allocatedBy(const std::function<void()>& body) {
+    AllocationCounts before = threadAllocationCounts();
+    body();
+    return (threadAllocationCounts() - before).bytes;
+}
+
+// Bytes malloc adds on top of a request of this size (rounding plus chunk header)
+uint64_t allocatorOverhead(size_t size) {
+    uint64_t before = processHeapFootprint();
+    void* ptr = ::operator new(size);
+    uint64_t chunk = processHeapFootprint() - before;
+    ::operator delete(ptr);
+    return chunk - size;
+}
+
+BenchResult measure(size_t orders, size_t levels) {
+    // Stand-ins for the default book's containers: a tree of levels per side
+    // and an index of each resting order's side and price
+    std::map<double, LevelQueue<double, uint32_t>> price_map;
+    std::unordered_map<uint64_t, std::pair<OrderSide, double>> index;
+    index.reserve(16);
+    uint64_t map_node = allocatedBy([&] { price_map.emplace(1.0, LevelQueue<double, uint32_t>{}); });
+    uint64_t index_node = allocatedBy([&] { index.emplace(1, std::make_pair(OrderSide::BUY, 1.0)); });
+    uint64_t entry = sizeof(uint64_t) + sizeof(uint32_t);
+
+    uint64_t rss_before = rssBytes();
+    uint64_t footprint_before = processHeapFootprint();
+    AllocationCounts start = threadAllocationCounts();
+
+    auto book = std::make_unique<OrderBook>();
+    uint64_t baseline = processHeapFootprint() - footprint_before;
+    auto load_start = Clock::now();
+    for (size_t i = 0; i < orders; ++i) {
+        OrderSide side = i % 2 ? OrderSide::SELL : OrderSide::BUY;
+        int64_t ticks = static_cast<int64_t>((i / 2) % levels) + 1;
+        double price = (side == OrderSide::BUY ? 1000000 - ticks : 1000000 + ticks) / 10000.0;
+        book->processOrderSync(std::make_unique<Order>(i + 1, side, price, 10));
+    }
+    uint64_t load_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - load_start).count());
+
+    AllocationCounts loaded = threadAllocationCounts() - start;
+    uint64_t footprint = processHeapFootprint() - footprint_before;
+    uint64_t rss = rssBytes() - rss_before;
+    if (book->getBuyOrdersCount() + book->getSellOrdersCount() != orders) {
+        std::cerr << "Orders crossed while loading\n";
+    }
+
+    // The per-order and per-level parts are known exactly; what remains of the
+    // live heap is the hash bucket array (earlier ones were freed by
+    // rehashing) and the level arrays' spare capacity
+    double n = static_cast<double>(orders);
+    double level_count = static_cast<double>(book->getDepth(OrderSide::BUY).size() +
+                                             book->getDepth(OrderSide::SELL).size());
+    double level_node = (map_node + allocatorOverhead(map_node)) * level_count / n;
+    double overhead = static_cast<double>(allocatorOverhead(index_node));
+    double per_order = entry + level_node + index_node + overhead;
+    double heap_per_order = footprint / n;
+    double other = heap_per_order - per_order - baseline / n;
+
+    BenchResult result;
+    result.suite = "memory";
+    result.name = "resting_orders";
+    result.params = {{"orders", std::to_string(orders)}, {"levels", std::to_string(levels)}};
+    result.ops = orders;
+    result.total_ns = load_ns;
+    result.extra = {
+        {"rss_bytes", static_cast<double>(rss)},
+        {"rss_per_order", rss / n},
+        {"heap_per_order", heap_per_order},
+        {"entry", static_cast<double>(entry)},
+        {"level_node", level_node},
+        {"index_node", static_cast<double>(index_node)},
+        {"other", other > 0 ? other : 0.0},
+        {"book", baseline / n},
+        {"allocator", overhead},
+        {"allocs_per_order", loaded.allocations / n},
+    };
+    return result;
+}
+
+// Runs measure() in a child so every size starts from a clean heap and RSS
+bool measureInChild(size_t orders, size_t levels, BenchResult& result) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return false;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        BenchReporter reporter;
+        reporter.add(measure(orders, levels));
+        std::ostringstream json;
+        reporter.writeJson(json);
+        std::string line = json.str();
+        ssize_t written = write(fds[1], line.data(), line.size());
+        _exit(written == static_cast<ssize_t>(line.size()) ? 0 : 1);
+    }
+    close(fds[1]);
+    std::string line;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = read(fds[0], buffer, sizeof(buffer))) > 0) {
+        line.append(buffer, static_cast<size_t>(n));
+    }
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    BenchEnvironment env;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 && parseBenchJson(line, result, env);
+}
+
+double extraValue(const BenchResult& result, const std::string& name) {
+    for (const auto& [key, value] : result.extra) {
+        if (key == name) {
+            return value;
+        }
+    }
+    return 0.0;
+}
+
+std::vector<size_t> parseSizes(const std::string& list) {
+    std::vector<size_t> sizes;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        sizes.push_back(std::stoull(item));
+    }
+    return sizes;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> sizes = {1000000, 10000000, 50000000};
+    size_t levels = 1000;
+    BenchOutputOptions output;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (output.parse(arg)) {
+            continue;
+        } else if (arg.rfind("--orders=", 0) == 0) {
+            sizes = parseSizes(arg.substr(9));
+        } else if (arg.rfind("--levels=", 0) == 0) {
+            levels = std::max<size_t>(std::stoull(arg.substr(9)), 1);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--orders=N,N,...] [--levels=N]"
+                      << " [--format=table|json] [--out=FILE]\n";
+            return 2;
+        }
+    }
+
+    BenchReporter reporter;
+    double bytes_per_order = 0.0;
+    for (size_t orders : sizes) {
+        // Leave headroom: the parent, page tables and the allocator's own slack
+        double needed = bytes_per_order * orders * 1.25;
+        if (needed > availableBytes()) {
+            std::cerr << "Skipping " << orders << " orders: needs ~" << (static_cast<uint64_t>(needed) >> 20)
+                      << "MB, " << (availableBytes() >> 20) << "MB available\n";
+            continue;
+        }
+        BenchResult result;
+        if (!measureInChild(orders, levels, result)) {
+            std::cerr << "Run with " << orders << " orders failed\n";
+            return 1;
+        }
+        bytes_per_order = std::max(bytes_per_order, extraValue(result, "rss_per_order"));
+        reporter.add(std::move(result));
+    }
+    return output.write(reporter) ? 0 : 1;
+}
@@ -0,0 +1,578 @@
+// Microbenchmarks for the core OrderBook operations at a range of book sizes.
+// Each operation runs through the synchronous matching path and is timed
+// individually, so results include ~20ns of clock overhead per sample.
+//
+//   ./order_book_bench [--sizes=1000,10000,...] [--ops=N] [--per-level=N]
+//                      [--store=tree|ladder|sorted|tiered] [--spacing=TICKS] [--recenter-step=TICKS]
+//                      [--format=table|json] [--out=FILE]
+// --spacing leaves empty ticks between adjacent levels, for thin books.
+// --recenter-step lets the ladder's window follow the trend benchmark.
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "order_book.hpp"
+#include "basic_order_book.hpp"
+#include "bench_report.hpp"
+
+using namespace OrderEngine;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t elapsedNs(Clock::time_point start, Clock::time_point end) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+// Symmetric book around 100.0000 with a 0.0001 tick: level j of the bids sits
+// (j+1) * spacing ticks below the mid and level j of the asks as far above it.
+class BookFixture {
+public:
+    static constexpr uint32_t kQuantity = 10;
+    
+    BookFixture(size_t size, size_t per_level, LevelStoreType store, size_t spacing, size_t recenter_step)
+        : half_(std::max<size_t>(size / 2, 1)), per_level_(std::max<size_t>(per_level, 1)),
+          spacing_(std::max<size_t>(spacing, 1)), config_(bookConfig(store, recenter_step)), book_(config_) {
+        book_.setTradeCallback([this](const Trade&) { trades_++; });
+        ids_.reserve(half_ * 2);
+        for (size_t i = 0; i < half_ * 2; ++i) {
+            ids_.push_back(rest(i));
+        }
+    }
+    
+    OrderBook& book() { return book_; }
+    const OrderBookConfig& config() const { return config_; }
+    size_t spacing() const { return spacing_; }
+    size_t restingCount() const { return ids_.size(); }
+    size_t perLevel() const { return per_level_; }
+    uint64_t trades() const { return trades_; }
+    uint64_t nextId() { return next_id_++; }
+    
+    double price(OrderSide side, size_t level) const {
+        int64_t ticks = static_cast<int64_t>((level + 1) * spacing_);
+        return (side == OrderSide::BUY ? 1000000 - ticks : 1000000 + ticks) / 10000.0;
+    }
+    static double mid() { return 100.0; }
+    
+    OrderSide sideOf(size_t slot) const { return slot < half_ ? OrderSide::BUY : OrderSide::SELL; }
+    size_t levelOf(size_t slot) const { return (slot % half_) / per_level_; }
+    uint64_t idOf(size_t slot) const { return ids_[slot]; }
+    
+    // Re-adds the order for a slot (after a cancel or fill) at the back of its level
+    uint64_t rest(size_t slot) {
+        uint64_t id = nextId();
+        book_.processOrderSync(std::make_unique<Order>(id, sideOf(slot), price(sideOf(slot), levelOf(slot)), kQuantity));
+        if (slot < ids_.size()) {
+            ids_[slot] = id;
+        }
+        return id;
+    }
+    
+private:
+    size_t half_;
+    size_t per_level_;
+    size_t spacing_;
+    OrderBookConfig config_;
+    OrderBook book_;
+    std::vector<uint64_t> ids_;  // Resting order id per slot
+    uint64_t next_id_{1};
+    uint64_t trades_{0};
+    
+    // A ladder spans the deepest bid to the deepest ask
+    OrderBookConfig bookConfig(LevelStoreType store, size_t recenter_step) const {
+        OrderBookConfig config;
+        config.level_store = store;
+        int64_t reach = static_cast<int64_t>(((half_ + per_level_ - 1) / per_level_) * spacing_);
+        config.ladder.tick_size = 0.0001;
+        config.ladder.base_price = (1000000 - reach) / 10000.0;
+        config.ladder.levels = static_cast<size_t>(2 * reach + 1);
+        config.ladder.recenter_step = recenter_step;
+        config.tiered.tick_size = 0.0001;
+        return config;
+    }
+};
+
+BenchResult makeResult(const std::string& name, size_t book_size, size_t ops, uint64_t total_ns,
+                       const LatencyHistogram& latencies) {
+    BenchResult result;
+    result.suite = "order_book";
+    result.name = name;
+    result.params.emplace_back("book_size", std::to_string(book_size));
+    result.ops = ops;
+    result.total_ns = total_ns;
+    result.setPercentiles(latencies);
+    return result;
+}
+
+// A non-crossing order at a random existing level, cancelled again off the clock
+BenchResult benchRestingInsert(BookFixture& fixture, size_t book_size, size_t ops, std::mt19937& rng) {
+    std::uniform_int_distribution<size_t> slot_dist(0, fixture.restingCount() - 1);
+    LatencyHistogram latencies;
+    uint64_t total_ns = 0;
+    for (size_t i = 0; i < ops; ++i) {
+        size_t slot = slot_dist(rng);
+        OrderSide side = fixture.sideOf(slot);
+        uint64_t id = fixture.nextId();
+        auto order = std::make_unique<Order>(id, side, fixture.price(side, fixture.levelOf(slot)),
+                                             BookFixture::kQuantity);
+        
+        auto start = Clock::now();
+        fixture.book().processOrderSync(std::move(order));
+        uint64_t ns = elapsedNs(start, Clock::now());
+        
+        latencies.record(ns);
+        total_ns += ns;
+        fixture.book().cancelOrderSync(id);
+    }
+    return makeResult("resting_insert", book_size, ops, total_ns, latencies);
+}
+
+// A buy that takes out the first `levels` ask levels completely; refilled off the clock
+BenchResult benchAggressiveMatch(BookFixture& fixture, size_t book_size, size_t ops, size_t levels) {
+    size_t per_level = fixture.perLevel();
+    size_t half = fixture.restingCount() / 2;
+    levels = std::min(levels, std::max<size_t>(half / per_level, 1));
+    size_t swept_orders = std::min(levels * per_level, half);
+    uint32_t quantity = static_cast<uint32_t>(swept_orders * BookFixture::kQuantity);
+    double limit = fixture.price(OrderSide::SELL, levels - 1);
+    
+    LatencyHistogram latencies;
+    uint64_t total_ns = 0;
+    for (size_t i = 0; i < ops; ++i) {
+        auto order = std::make_unique<Order>(fixture.nextId(), OrderSide::BUY, limit, quantity);
+        
+        auto start = Clock::now();
+        fixture.book().processOrderSync(std::move(order));
+        uint64_t ns = elapsedNs(start, Clock::now());
+        
+        latencies.record(ns);
+        total_ns += ns;
+        for (size_t slot = half; slot < half + swept_orders; ++slot) {
+            fixture.rest(slot);
+        }
+    }
+    BenchResult result = makeResult("aggressive_match", book_size, ops, total_ns, latencies);
+    result.params.emplace_back("levels", std::to_string(levels));
+    result.extra.emplace_back("orders_per_op", static_cast<double>(swept_orders));
+    return result;
+}
+
+// A one-lot sell against a large bid at the mid: the resting order is only ever partially filled
+BenchResult benchPartialFill(BookFixture& fixture, size_t book_size, size_t ops) {
+    uint64_t big_id = fixture.nextId();
+    fixture.book().processOrderSync(std::make_unique<Order>(big_id, OrderSide::BUY, BookFixture::mid(),
+                                                            static_cast<uint32_t>(ops + 1)));
+    
+    LatencyHistogram latencies;
+    uint64_t total_ns = 0;
+    for (size_t i = 0; i < ops; ++i) {
+        auto order = std::make_unique<Order>(fixture.nextId(), OrderSide::SELL, BookFixture::mid(), 1);
+        
+        auto start = Clock::now();
+        fixture.book().processOrderSync(std::move(order));
+        uint64_t ns = elapsedNs(start, Clock::now());
+        
+        latencies.record(ns);
+        total_ns += ns;
+    }
+    fixture.book().cancelOrderSync(big_id);
+    return makeResult("partial_fill", book_size, ops, total_ns, latencies);
+}
+
+// Cancel of a random resting order; a replacement is rested off the clock
+BenchResult benchCancel(BookFixture& fixture, size_t book_size, size_t ops, std::mt19937& rng) {
+    std::uniform_int_distribution<size_t> slot_dist(0, fixture.restingCount() - 1);
+    LatencyHistogram latencies;
+    uint64_t total_ns = 0;
+    size_t cancelled = 0;
+    for (size_t i = 0; i < ops; ++i) {
+        size_t slot = slot_dist(rng);
+        uint64_t id = fixture.idOf(slot);
+        
+        auto start = Clock::now();
+        cancelled += fixture.book().cancelOrderSync(id);
+        uint64_t ns = elapsedNs(start, Clock::now());
+        
+        latencies.record(ns);
+        total_ns += ns;
+        fixture.rest(slot);
+    }
+    BenchResult result = makeResult("cancel", book_size, ops, total_ns, latencies);
+    result.extra.emplace_back("cancelled", static_cast<double>(cancelled));
+    return result;
+}
+
+// Best bid and ask, timed in batches because a single query is close to clock resolution
+BenchResult benchTopOfBook(BookFixture& fixture, size_t book_size, size_t ops) {
+    constexpr size_t kBatch = 64;
+    size_t batches = std::max<size_t>(ops / kBatch, 1);
+    LatencyHistogram latencies;
+    uint64_t total_ns = 0;
+    double checksum = 0.0;
+    for (size_t b = 0; b < batches; ++b) {
+        auto start = Clock::now();
+        for (size_t i = 0; i < kBatch; ++i) {
+            checksum += fixture.book().getBestBid().value_or(0.0);
+            checksum += fixture.book().getBestAsk().value_or(0.0);
+        }
+        uint64_t ns = elapsedNs(start, Clock::now());
+        latencies.record(ns / kBatch);
+        total_ns += ns;
+    }
+    BenchResult result = makeResult("top_of_book", book_size, batches * kBatch, total_ns, latencies);
+    result.extra.emplace_back("checksum", checksum);
+    return result;
+}
+
+// The market walks up a level per op on a book of its own with the fixture's
+// depth and window, one order a level: a buy takes the best ask, a bid joins
+// at the old mid, an ask joins behind the deepest one and the deepest bid is
+// cancelled. A fixed ladder starts rejecting as soon as the walk leaves its
+// window; a recentering one follows it.
+BenchResult benchTrend(BookFixture& fixture, size_t book_size, size_t ops) {
+    OrderBook book(fixture.config());
+    int64_t spacing = static_cast<int64_t>(fixture.spacing());
+    size_t depth = std::max<size_t>(book_size / 2 / fixture.perLevel(), 1);
+    int64_t mid = 1000000;
+    uint64_t next_id = 1;
+    std::deque<uint64_t> bids;  // Deepest first
+    auto submit = [&](OrderSide side, int64_t ticks, uint32_t quantity) {
+        book.processOrderSync(std::make_unique<Order>(next_id, side, ticks / 10000.0, quantity));
+        return next_id++;
+    };
+    for (size_t level = depth; level > 0; --level) {
+        bids.push_back(submit(OrderSide::BUY, mid - static_cast<int64_t>(level) * spacing, BookFixture::kQuantity));
+        submit(OrderSide::SELL, mid + static_cast<int64_t>(level) * spacing, BookFixture::kQuantity);
+    }
+    
+    LevelStoreStats loaded = book.getLevelStoreStats();  // Window moves while the book filled
+    LatencyHistogram latencies;
+    uint64_t total_ns = 0;
+    for (size_t i = 0; i < ops; ++i) {
+        auto start = Clock::now();
+        mid += spacing;
+        submit(OrderSide::BUY, mid, BookFixture::kQuantity);
+        bids.push_back(submit(OrderSide::BUY, mid - spacing, BookFixture::kQuantity));
+        submit(OrderSide::SELL, mid + static_cast<int64_t>(depth) * spacing, BookFixture::kQuantity);
+        book.cancelOrderSync(bids.front());
+        uint64_t ns = elapsedNs(start, Clock::now());
+        
+        bids.pop_front();
+        latencies.record(ns);
+        total_ns += ns;
+    }
+    
+    BenchResult result = makeResult("trend", book_size, ops, total_ns, latencies);
+    result.extra.emplace_back("rejected", static_cast<double>(book.getRejectedCount()));
+    LevelStoreType store = book.getLevelStoreType();
+    if (store == LevelStoreType::LADDER || store == LevelStoreType::TIERED) {
+        LevelStoreStats stats = book.getLevelStoreStats();
+        result.extra.emplace_back("window_moves", static_cast<double>(stats.window_moves - loaded.window_moves));
+        result.extra.emplace_back("slots_per_op",
+                                  static_cast<double>(stats.slots_moved - loaded.slots_moved) / std::max<size_t>(ops, 1));
+        result.extra.emplace_back("levels_migrated", static_cast<double>(stats.levels_migrated - loaded.levels_migrated));
+    }
+    return result;
+}
+
+// One operation of the policy comparison, in 0.0001 ticks
+struct PolicyOp {
+    bool cancel;
+    OrderSide side;
+    int32_t ticks;
+    uint32_t quantity;
+    uint64_t id;  // New order's id, or the cancel target
+};
+
+// The fixture's book as new orders, then `ops` operations: 80% orders at a
+// random level of their side, a tenth of them crossing up to two levels
+// deep, and 20% cancels of an earlier order, which may already be filled
+std::vector<PolicyOp> policyWorkload(const BookFixture& fixture, size_t book_size, size_t ops, std::mt19937& rng,
+                                     size_t& prefill) {
+    std::vector<PolicyOp> workload;
+    size_t half = std::max<size_t>(book_size / 2, 1);
+    size_t levels = std::max<size_t>((half + fixture.perLevel() - 1) / fixture.perLevel(), 1);
+    auto ticksOf = [](double price) { return static_cast<int32_t>(std::llround(price * 10000)); };
+    uint64_t next_id = 1;
+    for (size_t slot = 0; slot < half * 2; ++slot) {
+        OrderSide side = slot < half ? OrderSide::BUY : OrderSide::SELL;
+        workload.push_back({false, side, ticksOf(fixture.price(side, (slot % half) / fixture.perLevel())),
+                            BookFixture::kQuantity, next_id++});
+    }
+    prefill = workload.size();
+    
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<size_t> level_dist(0, levels - 1);
+    std::uniform_int_distribution<uint32_t> quantity_dist(1, 2 * BookFixture::kQuantity);
+    for (size_t i = 0; i < ops; ++i) {
+        if (unit(rng) < 0.2) {
+            std::uniform_int_distribution<uint64_t> target(1, next_id - 1);
+            workload.push_back({true, OrderSide::BUY, 0, 0, target(rng)});
+            continue;
+        }
+        OrderSide side = unit(rng) < 0.5 ? OrderSide::BUY : OrderSide::SELL;
+        OrderSide level_side = side;
+        size_t level = level_dist(rng);
+        if (unit(rng) < 0.1) {
+            level_side = side == OrderSide::BUY ? OrderSide::SELL : OrderSide::BUY;
+            level = std::min<size_t>(level % 2, levels - 1);
+        }
+        workload.push_back({false, side, ticksOf(fixture.price(level_side, level)), quantity_dist(rng), next_id++});
+    }
+    return workload;
+}
+
+// Counts trades without leaving the matching loop
+struct TradeCounter {
+    uint64_t trades = 0;
+    
+    template<typename Trade>
+    void onTrade(const Trade&) { trades++; }
+};
+
+// Replays a policy workload; submit(op) and cancel(id) adapt the book's API
+template<typename Submit, typename Cancel>
+BenchResult runPolicyBook(const std::string& name, const std::vector<PolicyOp>& workload, size_t prefill,
+                          size_t book_size, Submit&& submit, Cancel&& cancel) {
+    for (size_t i = 0; i < prefill; ++i) {
+        submit(workload[i]);
+    }
+    LatencyHistogram latencies;
+    uint64_t total_ns = 0;
+    for (size_t i = prefill; i < workload.size(); ++i) {
+        const PolicyOp& op = workload[i];
+        auto start = Clock::now();
+        if (op.cancel) {
+            cancel(op.id);
+        } else {
+            submit(op);
+        }
+        uint64_t ns = elapsedNs(start, Clock::now());
+        latencies.record(ns);
+        total_ns += ns;
+    }
+    BenchResult result = makeResult("policy_mix", book_size, workload.size() - prefill, total_ns, latencies);
+    result.params.emplace_back("book", name);
+    return result;
+}
+
+// OrderBook against the BasicOrderBook instantiations it could be, on the same
+// workload: from its own matching core without the fill batching and
+// callbacks to int ticks on a dense ladder with an inline listener. The
+// workload has its own generator, so the rows before these draw the same
+// numbers whether or not the policy rows run.
+std::vector<BenchResult> benchPolicies(const BookFixture& fixture, size_t book_size, size_t ops) {
+    std::mt19937 rng(7);
+    size_t prefill = 0;
+    std::vector<PolicyOp> workload = policyWorkload(fixture, book_size, ops, rng, prefill);
+    int32_t low = workload.front().ticks, high = low;
+    for (const auto& op : workload) {
+        if (!op.cancel) {
+            low = std::min(low, op.ticks);
+            high = std::max(high, op.ticks);
+        }
+    }
+    LadderConfig dense;  // Exactly the workload's ticks
+    dense.levels = static_cast<size_t>(high - low) + 1;
+    dense.base_price = low;
+    
+    std::vector<BenchResult> results;
+    uint64_t trades = 0;
+    auto countTrade = [&](const auto&) { trades++; };
+    // Called once the run is over, so trades is final
+    auto finish = [&](BenchResult result) {
+        result.extra.emplace_back("trades", static_cast<double>(trades));
+        results.push_back(std::move(result));
+        trades = 0;
+    };
+    {
+        OrderBook book;
+        book.setTradeCallback(countTrade);
+        finish(runPolicyBook("OrderBook", workload, prefill, book_size,
+            [&](const PolicyOp& op) {
+                book.processOrderSync(std::make_unique<Order>(op.id, op.side, op.ticks / 10000.0, op.quantity));
+            },
+            [&](uint64_t id) { book.cancelOrderSync(id); }));
+    }
+    auto runBasic = [&](const std::string& name, auto& book, auto toPrice) {
+        return runPolicyBook(name, workload, prefill, book_size,
+                             [&](const PolicyOp& op) { book.submit(op.id, op.side, toPrice(op.ticks), op.quantity); },
+                             [&](uint64_t id) { book.cancel(id); });
+    };
+    auto asDouble = [](int32_t ticks) { return ticks / 10000.0; };
+    auto asTicks = [](int32_t ticks) { return ticks; };
+    {
+        BasicOrderBook<> book;
+        book.listener().callback = countTrade;
+        finish(runBasic("default", book, asDouble));
+    }
+    {
+        BasicOrderBook<int32_t> book;
+        book.listener().callback = countTrade;
+        finish(runBasic("int_ticks", book, asTicks));
+    }
+    {
+        BasicOrderBook<int32_t, uint32_t, LadderLevelStore> book(dense);
+        book.listener().callback = countTrade;
+        finish(runBasic("int_ticks_dense", book, asTicks));
+    }
+    {
+        BasicOrderBook<int32_t, uint32_t, LadderLevelStore, FifoMatching, TradeCounter> book(dense);
+        BenchResult result = runBasic("int_ticks_dense_inline", book, asTicks);
+        trades = book.listener().trades;
+        finish(std::move(result));
+    }
+    return results;
+}
+
+// One incoming order shared across a single level of `orders` resting orders
+// of 1..100 lots, for a quarter of the level's size; the level is restored
+// off the clock. FIFO is the baseline for the pro-rata policies; the level
+// comes from its own generator seeded by size, so every policy shares out
+// the same one.
+template<typename Matching>
+BenchResult benchLevelAllocation(const std::string& policy, size_t orders, size_t ops) {
+    std::mt19937 rng(static_cast<uint32_t>(orders));
+    LevelQueue<double, uint32_t> original;
+    std::uniform_int_distribution<uint32_t> size_dist(1, 100);
+    uint64_t total = 0;
+    for (size_t i = 0; i < orders; ++i) {
+        original.push(i + 1, size_dist(rng));
+        total += original.quantities.back();
+    }
+    uint32_t incoming = static_cast<uint32_t>(std::max<uint64_t>(total / 4, 1));
+    
+    LevelQueue<double, uint32_t> level;
+    LatencyHistogram latencies;
+    uint64_t total_ns = 0;
+    uint64_t fills = 0;
+    for (size_t i = 0; i < ops; ++i) {
+        level.ids = original.ids;
+        level.quantities = original.quantities;
+        level.head = 0;
+        
+        auto start = Clock::now();
+        Matching::match(level, incoming, [&](uint64_t, uint32_t, uint32_t) { fills++; });
+        uint64_t ns = elapsedNs(start, Clock::now());
+        
+        latencies.record(ns);
+        total_ns += ns;
+    }
+    BenchResult result;
+    result.suite = "order_book";
+    result.name = "level_allocation";
+    result.params = {{"orders", std::to_string(orders)}, {"policy", policy}};
+    result.ops = ops;
+    result.total_ns = total_ns;
+    result.setPercentiles(latencies);
+    result.extra.emplace_back("fills_per_op", static_cast<double>(fills) / std::max<size_t>(ops, 1));
+    return result;
+}
+
+std::vector<size_t> parseSizes(const std::string& list) {
+    std::vector<size_t> sizes;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        sizes.push_back(std::stoull(item));
+    }
+    return sizes;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> sizes = {1000, 10000, 100000, 1000000, 10000000};
+    size_t ops = 10000;
+    size_t per_level = 10;
+    LevelStoreType store = LevelStoreType::TREE;
+    size_t spacing = 1;
+    size_t recenter_step = 0;
+    BenchOutputOptions output;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (output.parse(arg)) {
+            continue;
+        } else if (arg.rfind("--sizes=", 0) == 0) {
+            sizes = parseSizes(arg.substr(8));
+        } else if (arg.rfind("--ops=", 0) == 0) {
+            ops = std::stoull(arg.substr(6));
+        } else if (arg.rfind("--per-level=", 0) == 0) {
+            per_level = std::stoull(arg.substr(12));
+        } else if (arg == "--store=tree") {
+            store = LevelStoreType::TREE;
+        } else if (arg == "--store=ladder") {
+            store = LevelStoreType::LADDER;
+        } else if (arg == "--store=sorted") {
+            store = LevelStoreType::SORTED;
+        } else if (arg == "--store=tiered") {
+            store = LevelStoreType::TIERED;
+        } else if (arg.rfind("--spacing=", 0) == 0) {
+            spacing = std::stoull(arg.substr(10));
+        } else if (arg.rfind("--recenter-step=", 0) == 0) {
+            recenter_step = std::stoull(arg.substr(16));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--sizes=N,N,...] [--ops=N] [--per-level=N]"
+                      << " [--store=tree|ladder|sorted|tiered] [--spacing=TICKS] [--recenter-step=TICKS]"
+                      << " [--format=table|json] [--out=FILE]\n";
+            return 2;
+        }
+    }
+    
+    BenchReporter reporter;
+    std::mt19937 rng(42);
+    for (size_t size : sizes) {
+        BookFixture fixture(size, per_level, store, spacing, recenter_step);
+        auto add = [&](BenchResult result) {
+            result.params.emplace_back("per_level", std::to_string(per_level));
+            // Only non-default layouts are tagged, so existing baselines still line up
+            if (store != LevelStoreType::TREE) {
+                const char* names[] = {"tree", "ladder", "sorted", "tiered"};
+                result.params.emplace_back("store", names[static_cast<int>(store)]);
+            }
+            if (spacing > 1) {
+                result.params.emplace_back("spacing", std::to_string(spacing));
+            }
+            if (recenter_step > 0 && store == LevelStoreType::LADDER) {
+                result.params.emplace_back("recenter_step", std::to_string(recenter_step));
+            }
+            reporter.add(std::move(result));
+        };
+        add(benchRestingInsert(fixture, size, ops, rng));
+        for (size_t levels : {1, 10, 50}) {
+            // Sweeps are refilled order by order, so run fewer of the wide ones
+            add(benchAggressiveMatch(fixture, size, std::max<size_t>(ops / levels, 1), levels));
+        }
+        add(benchPartialFill(fixture, size, ops));
+        add(benchCancel(fixture, size, ops, rng));
+        add(benchTopOfBook(fixture, size, ops));
+        add(benchTrend(fixture, size, ops));
+        // The policy books pick their own containers, so they run once, with the default store
+        if (store == LevelStoreType::TREE) {
+            for (auto& result : benchPolicies(fixture, size, ops)) {
+                add(std::move(result));
+            }
+        }
+        
+        if (fixture.book().getBuyOrdersCount() + fixture.book().getSellOrdersCount() != fixture.restingCount()) {
+            std::cerr << "Book size drifted at size " << size << "\n";
+            return 1;
+        }
+    }
+    if (store == LevelStoreType::TREE) {
+        for (size_t orders : {10, 100, 1000, 10000}) {
+            // Restoring a wide level dominates the run, so time fewer of them
+            size_t level_ops = std::max<size_t>(ops / std::max<size_t>(orders / 1000, 1), 1);
+            reporter.add(benchLevelAllocation<FifoMatching>("fifo", orders, level_ops));
+            reporter.add(benchLevelAllocation<ProRataMatching<>>("pro_rata", orders, level_ops));
+            reporter.add(benchLevelAllocation<ProRataMatching<true>>("pro_rata_top", orders, level_ops));
+        }
+    }
+    return output.write(reporter) ? 0 : 1;
+}
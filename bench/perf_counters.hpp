@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+namespace OrderEngine {
+
+// Hardware counters for the calling thread via perf_event_open. Events the
+// kernel or VM does not expose (perf_event_paranoid, no PMU) are skipped and
+// software counters (task clock, page faults, context switches) still work.
+class PerfCounters {
+public:
+    enum Event {
+        CYCLES,
+        INSTRUCTIONS,
+        L1D_MISSES,
+        LLC_MISSES,
+        BRANCH_MISSES,
+        TASK_CLOCK_NS,
+        PAGE_FAULTS,
+        CONTEXT_SWITCHES,
+        EVENT_COUNT
+    };
+    
+    struct Sample {
+        uint64_t values[EVENT_COUNT] = {};
+        bool available[EVENT_COUNT] = {};
+        
+        bool has(Event event) const { return available[event]; }
+        double perOp(Event event, uint64_t ops) const {
+            return ops > 0 ? static_cast<double>(values[event]) / ops : 0.0;
+        }
+        double ipc() const {
+            return values[CYCLES] > 0 ? static_cast<double>(values[INSTRUCTIONS]) / values[CYCLES] : 0.0;
+        }
+    };
+    
+    PerfCounters();
+    ~PerfCounters();
+    
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+    
+    void start();
+    Sample stop();
+    
+    bool hasHardwareCounters() const { return fds_[CYCLES] >= 0; }
+    static const char* eventName(Event event);
+    
+private:
+    int fds_[EVENT_COUNT];
+};
+
+} // namespace OrderEngine
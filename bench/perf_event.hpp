@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace OrderEngine {
+
+// Opens a counter for the calling thread on any CPU, user and kernel mode
+// when permitted. Returns -1 if the event is unsupported or restricted.
+inline int openPerfEvent(uint32_t type, uint64_t config, int group_fd = -1, bool exclude_kernel = false) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = group_fd == -1 ? 1 : 0;
+    attr.exclude_kernel = exclude_kernel ? 1 : 0;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+    if (fd < 0 && !exclude_kernel) {
+        // perf_event_paranoid >= 2 only allows user-mode counting
+        return openPerfEvent(type, config, group_fd, true);
+    }
+    return fd;
+}
+
+// Reads a counter opened by openPerfEvent, scaled for multiplexing
+inline uint64_t readPerfEvent(int fd) {
+    uint64_t values[3] = {0, 0, 0};  // value, time enabled, time running
+    if (fd < 0 || read(fd, values, sizeof(values)) != static_cast<ssize_t>(sizeof(values))) {
+        return 0;
+    }
+    if (values[2] == 0 || values[2] == values[1]) {
+        return values[0];
+    }
+    return static_cast<uint64_t>(static_cast<double>(values[0]) * values[1] / values[2]);
+}
+
+} // namespace OrderEngine
@@ -0,0 +1,162 @@
+// Per-phase hardware counters for the core OrderBook operations. Reports
+// wall time, IPC and cache/branch misses per operation so data-structure
+// changes can be justified with more than wall time.
+//
+//   ./order_book_phases [--orders=N] [--levels=N]
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "order_book.hpp"
+#include "parser.hpp"
+#include "perf_counters.hpp"
+
+using namespace OrderEngine;
+
+struct PhaseResult {
+    std::string name;
+    uint64_t ops;
+    uint64_t wall_ns;
+    PerfCounters::Sample sample;
+};
+
+template<typename Body>
+static PhaseResult runPhase(PerfCounters& counters, const std::string& name, uint64_t ops, Body&& body) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    counters.start();
+    body();
+    PerfCounters::Sample sample = counters.stop();
+    auto end_time = std::chrono::high_resolution_clock::now();
+    uint64_t wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+    return {name, ops, wall_ns, sample};
+}
+
+static void printResults(const std::vector<PhaseResult>& results, bool hardware) {
+    std::cout << std::left << std::setw(8) << "phase" << std::right
+              << std::setw(10) << "ops" << std::setw(10) << "ns/op";
+    if (hardware) {
+        std::cout << std::setw(12) << "cycles/op" << std::setw(12) << "instr/op" << std::setw(7) << "IPC"
+                  << std::setw(10) << "L1D/op" << std::setw(10) << "LLC/op" << std::setw(10) << "br-mis/op";
+    }
+    std::cout << std::setw(13) << "task-ns/op" << std::setw(10) << "faults" << std::setw(8) << "csw" << "\n";
+    
+    std::cout << std::fixed;
+    for (const auto& r : results) {
+        const auto& s = r.sample;
+        std::cout << std::left << std::setw(8) << r.name << std::right
+                  << std::setw(10) << r.ops
+                  << std::setw(10) << std::setprecision(1) << static_cast<double>(r.wall_ns) / r.ops;
+        if (hardware) {
+            std::cout << std::setw(12) << s.perOp(PerfCounters::CYCLES, r.ops)
+                      << std::setw(12) << s.perOp(PerfCounters::INSTRUCTIONS, r.ops)
+                      << std::setw(7) << std::setprecision(2) << s.ipc()
+                      << std::setprecision(3)
+                      << std::setw(10) << s.perOp(PerfCounters::L1D_MISSES, r.ops)
+                      << std::setw(10) << s.perOp(PerfCounters::LLC_MISSES, r.ops)
+                      << std::setw(10) << s.perOp(PerfCounters::BRANCH_MISSES, r.ops);
+        }
+        std::cout << std::setw(13) << std::setprecision(1) << s.perOp(PerfCounters::TASK_CLOCK_NS, r.ops)
+                  << std::setw(10) << s.values[PerfCounters::PAGE_FAULTS]
+                  << std::setw(8) << s.values[PerfCounters::CONTEXT_SWITCHES] << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t num_orders = 1000000;
+    int num_levels = 1000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--orders=", 0) == 0) {
+            num_orders = std::stoull(arg.substr(9));
+        } else if (arg.rfind("--levels=", 0) == 0) {
+            num_levels = std::max(std::stoi(arg.substr(9)), 1);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--orders=N] [--levels=N]\n";
+            return 2;
+        }
+    }
+    num_orders -= num_orders % 2;
+    
+    PerfCounters counters;
+    OrderBook order_book;
+    uint64_t trades = 0;
+    order_book.setTradeCallback([&trades](const Trade&) { trades++; });
+    std::vector<PhaseResult> results;
+    
+    // insert: alternating bids and asks spread over num_levels levels per side, no crossing
+    std::vector<std::unique_ptr<Order>> orders;
+    orders.reserve(num_orders);
+    for (size_t i = 0; i < num_orders; ++i) {
+        double offset = static_cast<double>(i / 2 % num_levels) * 0.01;
+        if (i % 2 == 0) {
+            orders.push_back(std::make_unique<Order>(i + 1, OrderSide::BUY, 99.99 - offset, 10));
+        } else {
+            orders.push_back(std::make_unique<Order>(i + 1, OrderSide::SELL, 100.01 + offset, 10));
+        }
+    }
+    results.push_back(runPhase(counters, "insert", num_orders, [&] {
+        for (auto& order : orders) {
+            order_book.processOrderSync(std::move(order));
+        }
+    }));
+    
+    // match: each aggressive buy takes out exactly one resting ask
+    orders.clear();
+    for (size_t i = 0; i < num_orders / 2; ++i) {
+        orders.push_back(std::make_unique<Order>(num_orders + i + 1, OrderSide::BUY, 1e9, 10));
+    }
+    results.push_back(runPhase(counters, "match", num_orders / 2, [&] {
+        for (auto& order : orders) {
+            order_book.processOrderSync(std::move(order));
+        }
+    }));
+    
+    // cancel: every remaining bid, in random order
+    std::vector<uint64_t> bid_ids;
+    for (size_t i = 0; i < num_orders; i += 2) {
+        bid_ids.push_back(i + 1);
+    }
+    std::shuffle(bid_ids.begin(), bid_ids.end(), std::mt19937(42));
+    size_t cancelled = 0;
+    results.push_back(runPhase(counters, "cancel", bid_ids.size(), [&] {
+        for (uint64_t id : bid_ids) {
+            cancelled += order_book.cancelOrderSync(id);
+        }
+    }));
+    
+    // parse: the parser logs every order to stdout, so that cost is included but silenced
+    std::vector<std::string> messages;
+    messages.reserve(num_orders);
+    for (size_t i = 0; i < num_orders; ++i) {
+        std::ostringstream json;
+        json << R"({"side":")" << (i % 2 ? "sell" : "buy") << R"(","price":)"
+             << std::fixed << std::setprecision(2) << 100.0 + (i % 500) * 0.01
+             << R"(,"quantity":)" << 1 + i % 100 << "}";
+        messages.push_back(json.str());
+    }
+    OrderParser parser;
+    size_t parsed = 0;
+    results.push_back(runPhase(counters, "parse", num_orders, [&] {
+        for (const auto& message : messages) {
+            parsed += parser.parseOrder(message).has_value();
+        }
+    }));
+    
+    std::cout << "=== ORDER BOOK PHASE COUNTERS ===\n";
+    std::cout << "Orders: " << num_orders << " | levels/side: " << num_levels
+              << " | trades: " << trades << " | cancelled: " << cancelled
+              << " | parsed: " << parsed << "\n";
+    if (!counters.hasHardwareCounters()) {
+        std::cout << "Hardware counters unavailable (perf_event_paranoid or no PMU); "
+                  << "reporting software counters only\n";
+    }
+    printResults(results, counters.hasHardwareCounters());
+    
+    bool ok = trades == num_orders / 2 && cancelled == num_orders / 2 && parsed == num_orders;
+    return ok ? 0 : 1;
+}
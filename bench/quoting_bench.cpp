@@ -0,0 +1,281 @@
+// Cancel-heavy market-maker flow. A few makers each keep --levels quotes a
+// side around a drifting mid; nearly every message (--requote-ratio) is a
+// cancel/replace of one quote onto the current ladder, the rest are takers
+// crossing the touch and cancelling any residual straight away (IOC). Deeper
+// resting interest (--background orders a side) sits outside the quoting band
+// so the book has a realistic size. The message stream is generated up front
+// and replayed through every book registered for differential fuzzing that
+// supports cancel, plus the fuzzer's flat reference book.
+//
+// Rows per book: requote (cancel + new), cancel and quote on their own, and
+// taker (order + residual cancel). The requote row carries the churn figures:
+// messages/sec, cancel hit ratio, orders added and removed per message, and
+// the median quote lifetime.
+//
+//   ./order_book_quoting [--messages=N] [--makers=N] [--levels=N] [--requote-ratio=R]
+//                        [--background=N] [--seed=N] [--format=table|json] [--out=FILE]
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "book_fuzz.hpp"
+#include "bench_report.hpp"
+
+using namespace OrderEngine;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t elapsedNs(Clock::time_point start, Clock::time_point end) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+constexpr int64_t kMidTicks = 1000000;
+constexpr double kTicksPerUnit = 10000.0;
+constexpr int64_t kBackgroundOffset = 20;  // Ticks beyond the quoting band
+
+struct Options {
+    size_t messages = 1000000;
+    size_t makers = 8;
+    size_t levels = 3;
+    double requote_ratio = 0.95;
+    size_t background = 1000;
+    uint64_t seed = 1;
+    BenchOutputOptions output;
+};
+
+enum class MessageType : uint8_t { REQUOTE, TAKER };
+
+// One client message; a requote cancels cancel_id and places id, a taker
+// places id and cancels whatever is left of it
+struct Message {
+    MessageType type;
+    OrderSide side;
+    uint64_t cancel_id;
+    uint64_t id;
+    double price;
+    uint32_t quantity;
+};
+
+struct Workload {
+    std::vector<Message> messages;
+    std::vector<Message> background;
+    std::vector<Message> initial_quotes;
+    std::vector<uint64_t> quote_lifetimes;  // Messages between placing and replacing a quote
+};
+
+double priceOf(int64_t ticks) {
+    return static_cast<double>(ticks) / kTicksPerUnit;
+}
+
+Workload generateWorkload(const Options& options) {
+    Workload workload;
+    std::mt19937_64 rng(options.seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    uint64_t next_id = 1;
+
+    for (size_t i = 0; i < options.background; ++i) {
+        for (OrderSide side : {OrderSide::BUY, OrderSide::SELL}) {
+            int64_t away = static_cast<int64_t>(options.levels) + kBackgroundOffset + static_cast<int64_t>(i % 100);
+            int64_t ticks = side == OrderSide::BUY ? kMidTicks - away : kMidTicks + away;
+            workload.background.push_back({MessageType::REQUOTE, side, 0, next_id++, priceOf(ticks), 100});
+        }
+    }
+
+    // Quote slot s: maker s / (2 * levels), then side, then level from the touch
+    size_t slots = options.makers * options.levels * 2;
+    int64_t mid = kMidTicks;
+    auto quotePrice = [&](size_t slot, int64_t mid_ticks) {
+        int64_t away = 1 + static_cast<int64_t>(slot % options.levels);
+        return (slot / options.levels) % 2 == 0 ? mid_ticks - away : mid_ticks + away;
+    };
+    auto quoteSide = [&](size_t slot) {
+        return (slot / options.levels) % 2 == 0 ? OrderSide::BUY : OrderSide::SELL;
+    };
+    std::vector<uint64_t> live(slots);
+    std::vector<size_t> placed_at(slots, 0);
+    for (size_t slot = 0; slot < slots; ++slot) {
+        live[slot] = next_id++;
+        workload.initial_quotes.push_back(
+            {MessageType::REQUOTE, quoteSide(slot), 0, live[slot], priceOf(quotePrice(slot, mid)), 100});
+    }
+
+    workload.messages.reserve(options.messages);
+    workload.quote_lifetimes.reserve(options.messages);
+    std::uniform_int_distribution<size_t> pick_slot(0, slots - 1);
+    std::uniform_int_distribution<uint32_t> taker_quantity(20, 300);
+    for (size_t i = 0; i < options.messages; ++i) {
+        // The mid wanders a tick at a time; makers chase it one quote per message
+        double step = unit(rng);
+        if (step < 0.02) {
+            mid += step < 0.01 ? 1 : -1;
+        }
+        if (unit(rng) < options.requote_ratio) {
+            size_t slot = pick_slot(rng);
+            uint64_t id = next_id++;
+            workload.messages.push_back({MessageType::REQUOTE, quoteSide(slot), live[slot], id,
+                                         priceOf(quotePrice(slot, mid)), 100});
+            workload.quote_lifetimes.push_back(i - placed_at[slot]);
+            live[slot] = id;
+            placed_at[slot] = i;
+        } else {
+            OrderSide side = unit(rng) < 0.5 ? OrderSide::BUY : OrderSide::SELL;
+            int64_t ticks = side == OrderSide::BUY ? mid + 2 : mid - 2;
+            uint64_t id = next_id++;
+            workload.messages.push_back({MessageType::TAKER, side, id, id, priceOf(ticks), taker_quantity(rng)});
+        }
+    }
+    return workload;
+}
+
+BookVariant referenceVariant() {
+    return {"Reference", [] { return makeReferenceBook(); }};
+}
+
+std::vector<BenchResult> runBook(const BookVariant& variant, const Workload& workload, const Options& options) {
+    auto book = variant.create();
+    for (const auto& message : workload.background) {
+        book->submit(message.id, message.side, message.price, message.quantity);
+    }
+    for (const auto& message : workload.initial_quotes) {
+        book->submit(message.id, message.side, message.price, message.quantity);
+    }
+    book->takeFills();
+
+    LatencyHistogram requote_latency;
+    LatencyHistogram cancel_latency;
+    LatencyHistogram quote_latency;
+    LatencyHistogram taker_latency;
+    uint64_t requote_ns = 0, cancel_ns = 0, quote_ns = 0, taker_ns = 0;
+    size_t requotes = 0, cancel_hits = 0, takers = 0, trades = 0;
+    size_t start_resting = book->orderCount(OrderSide::BUY) + book->orderCount(OrderSide::SELL);
+    size_t peak_resting = start_resting;
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < workload.messages.size(); ++i) {
+        const Message& message = workload.messages[i];
+        if (message.type == MessageType::REQUOTE) {
+            auto cancel_start = Clock::now();
+            bool hit = book->cancel(message.cancel_id);
+            auto quote_start = Clock::now();
+            book->submit(message.id, message.side, message.price, message.quantity);
+            auto quote_end = Clock::now();
+
+            uint64_t cancel = elapsedNs(cancel_start, quote_start);
+            uint64_t quote = elapsedNs(quote_start, quote_end);
+            cancel_latency.record(cancel);
+            quote_latency.record(quote);
+            requote_latency.record(cancel + quote);
+            cancel_ns += cancel;
+            quote_ns += quote;
+            requote_ns += cancel + quote;
+            requotes++;
+            cancel_hits += hit;
+        } else {
+            auto taker_start = Clock::now();
+            book->submit(message.id, message.side, message.price, message.quantity);
+            book->cancel(message.id);
+            uint64_t ns = elapsedNs(taker_start, Clock::now());
+            taker_latency.record(ns);
+            taker_ns += ns;
+            takers++;
+        }
+
+        // Fill bookkeeping is off the clock, sampled often enough to bound memory
+        if ((i & 1023) == 0 || i + 1 == workload.messages.size()) {
+            trades += book->takeFills().size();
+            peak_resting = std::max(peak_resting, book->orderCount(OrderSide::BUY) + book->orderCount(OrderSide::SELL));
+        }
+    }
+    uint64_t wall_ns = elapsedNs(start, Clock::now());
+    // Every message adds one order; whatever did not stay was cancelled or filled
+    size_t end_resting = book->orderCount(OrderSide::BUY) + book->orderCount(OrderSide::SELL);
+    size_t added = workload.messages.size();
+    size_t removed = start_resting + added - end_resting;
+
+    std::vector<uint64_t> lifetimes = workload.quote_lifetimes;
+    double median_lifetime_us = 0.0;
+    if (!lifetimes.empty()) {
+        std::nth_element(lifetimes.begin(), lifetimes.begin() + lifetimes.size() / 2, lifetimes.end());
+        double ns_per_message = static_cast<double>(wall_ns) / workload.messages.size();
+        median_lifetime_us = lifetimes[lifetimes.size() / 2] * ns_per_message / 1000.0;
+    }
+
+    std::vector<std::pair<std::string, std::string>> params = {
+        {"book", variant.name}, {"makers", std::to_string(options.makers)},
+        {"levels", std::to_string(options.levels)}, {"background", std::to_string(options.background)}};
+    auto makeResult = [&](const std::string& name, size_t ops, uint64_t total_ns, const LatencyHistogram& latency) {
+        BenchResult result;
+        result.suite = "quoting";
+        result.name = name;
+        result.params = params;
+        result.ops = ops;
+        result.total_ns = total_ns;
+        result.setPercentiles(latency);
+        return result;
+    };
+
+    double messages = static_cast<double>(workload.messages.size());
+    std::vector<BenchResult> results;
+    results.push_back(makeResult("requote", requotes, requote_ns, requote_latency));
+    results.back().extra = {
+        {"messages_per_sec", wall_ns > 0 ? messages * 1e9 / wall_ns : 0.0},
+        {"cancel_hit_ratio", requotes > 0 ? static_cast<double>(cancel_hits) / requotes : 0.0},
+        {"churn_per_msg", (added + removed) / messages},
+        {"median_quote_life_us", median_lifetime_us},
+        {"trades", static_cast<double>(trades)},
+        {"peak_resting", static_cast<double>(peak_resting)},
+    };
+    results.push_back(makeResult("cancel", requotes, cancel_ns, cancel_latency));
+    results.push_back(makeResult("quote", requotes, quote_ns, quote_latency));
+    results.push_back(makeResult("taker", takers, taker_ns, taker_latency));
+    return results;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (options.output.parse(arg)) {
+                continue;
+            } else if (arg.rfind("--messages=", 0) == 0) {
+                options.messages = std::stoull(arg.substr(11));
+            } else if (arg.rfind("--makers=", 0) == 0) {
+                options.makers = std::max<size_t>(std::stoull(arg.substr(9)), 1);
+            } else if (arg.rfind("--levels=", 0) == 0) {
+                options.levels = std::max<size_t>(std::stoull(arg.substr(9)), 1);
+            } else if (arg.rfind("--requote-ratio=", 0) == 0) {
+                options.requote_ratio = std::clamp(std::stod(arg.substr(16)), 0.0, 1.0);
+            } else if (arg.rfind("--background=", 0) == 0) {
+                options.background = std::stoull(arg.substr(13));
+            } else if (arg.rfind("--seed=", 0) == 0) {
+                options.seed = std::stoull(arg.substr(7));
+            } else {
+                throw std::invalid_argument(arg);
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Usage: " << argv[0] << " [--messages=N] [--makers=N] [--levels=N] [--requote-ratio=R]\n"
+                  << "  [--background=N] [--seed=N] [--format=table|json] [--out=FILE]\n";
+        return 2;
+    }
+
+    Workload workload = generateWorkload(options);
+    std::vector<BookVariant> books = bookVariants();
+    books.push_back(referenceVariant());
+
+    BenchReporter reporter;
+    for (const auto& book : books) {
+        for (auto& result : runBook(book, workload, options)) {
+            reporter.add(std::move(result));
+        }
+    }
+    return options.output.write(reporter) ? 0 : 1;
+}
@@ -0,0 +1,380 @@
+// Multi-core scaling of sharded matching: K independent books (one per
+// symbol) are split across 1..N matching threads, each thread owning the
+// books with symbol % threads == shard and driving them through the
+// synchronous path. The order stream is pregenerated per symbol and
+// interleaved with uniform or Zipf symbol skew, so every run sees the same
+// flow. Scenarios isolate the shared resources that can stop scaling:
+//
+//   matching  each shard thread walks its own slice of the stream and
+//             allocates its own orders: nothing shared but the allocator
+//   ingress   one producer thread allocates the orders and feeds a mutex +
+//             condvar queue per shard, as OrderBook's own queue does (adds the
+//             shared producer and cross-thread frees)
+//   logger    as matching, with every trade sent to one shared TradeLogger
+//
+// Per thread count: aggregate throughput, scaling efficiency against the
+// single-thread run of the same scenario (left out until --threads has run 1),
+// share of events on the hottest shard, and per-shard processing latency.
+//
+//   ./order_book_scaling [--books=K] [--events=N] [--threads=1,2,4,...]
+//                        [--skew=uniform|zipf] [--zipf-s=S] [--scenarios=matching,ingress,logger]
+//                        [--pin] [--log-dir=DIR] [--format=table|json] [--out=FILE]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "order_book.hpp"
+#include "logger.hpp"
+#include "cpu_affinity.hpp"
+#include "bench_report.hpp"
+#include "market_generator.hpp"
+
+using namespace OrderEngine;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t elapsedNs(Clock::time_point start, Clock::time_point end) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+struct Options {
+    size_t books = 64;
+    size_t events = 1000000;
+    std::vector<size_t> threads;
+    bool zipf = false;
+    double zipf_s = 1.0;
+    std::vector<std::string> scenarios = {"matching", "ingress", "logger"};
+    bool pin = false;
+    std::string log_dir = ".";
+    BenchOutputOptions output;
+};
+
+struct SymbolEvent {
+    uint32_t symbol;
+    MarketEvent event;
+};
+
+std::vector<SymbolEvent> generateStream(const Options& options) {
+    std::vector<MarketGenerator> generators;
+    for (size_t symbol = 0; symbol < options.books; ++symbol) {
+        GeneratorConfig config;
+        config.seed = 1 + symbol;
+        generators.emplace_back(config);
+    }
+
+    // Zipf: symbol k (0-based) has weight 1/(k+1)^s
+    std::vector<double> weights(options.books, 1.0);
+    if (options.zipf) {
+        for (size_t k = 0; k < options.books; ++k) {
+            weights[k] = 1.0 / std::pow(static_cast<double>(k + 1), options.zipf_s);
+        }
+    }
+    std::vector<double> cdf(options.books);
+    double total = 0.0;
+    for (size_t k = 0; k < options.books; ++k) {
+        total += weights[k];
+        cdf[k] = total;
+    }
+
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> pick(0.0, total);
+    std::vector<SymbolEvent> stream;
+    stream.reserve(options.events);
+    for (size_t i = 0; i < options.events; ++i) {
+        size_t symbol = std::min<size_t>(std::upper_bound(cdf.begin(), cdf.end(), pick(rng)) - cdf.begin(),
+                                         options.books - 1);
+        stream.push_back({static_cast<uint32_t>(symbol), generators[symbol].next()});
+    }
+    return stream;
+}
+
+// A shard's request queue for the ingress scenario; a null order is a cancel
+struct ShardQueue {
+    struct Request {
+        uint32_t symbol;
+        std::unique_ptr<Order> order;
+        uint64_t cancel_id;
+    };
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Request> requests;
+    bool done{false};
+};
+
+// Cache-line aligned so shards do not false-share their counters
+struct alignas(64) ShardStats {
+    LatencyHistogram latency;  // Processing time per event
+    uint64_t events{0};
+    uint64_t busy_ns{0};
+    uint64_t trades{0};
+};
+
+class ScalingRun {
+public:
+    ScalingRun(const Options& options, const std::vector<SymbolEvent>& stream,
+               const std::string& scenario, size_t threads)
+        : options_(options), stream_(stream), scenario_(scenario), threads_(threads),
+          books_(options.books), stats_(threads) {
+        if (scenario_ == "logger") {
+            log_path_ = options.log_dir + "/oe_scaling_trades.csv";
+            logger_ = std::make_unique<TradeLogger>(log_path_);
+            logger_->start();
+        }
+        for (size_t symbol = 0; symbol < books_.size(); ++symbol) {
+            ShardStats& stats = stats_[symbol % threads_];
+            books_[symbol].setTradeBatchCallback([this, &stats](const TradeBatch& batch) {
+                stats.trades += batch.fill_count;
+                if (logger_) {
+                    logger_->logTrades(batch);
+                }
+            });
+        }
+    }
+
+    ~ScalingRun() {
+        if (logger_) {
+            logger_->stop();
+            std::remove(log_path_.c_str());
+        }
+    }
+
+    // Returns wall time from the start signal until every shard finished
+    uint64_t run() {
+        std::vector<std::thread> workers;
+        std::vector<ShardQueue> queues(scenario_ == "ingress" ? threads_ : 0);
+        std::atomic<size_t> ready{0};
+        std::atomic<bool> go{false};
+        for (size_t shard = 0; shard < threads_; ++shard) {
+            workers.emplace_back([&, shard] {
+                ready++;
+                while (!go.load(std::memory_order_acquire)) {}
+                if (queues.empty()) {
+                    runDirect(shard);
+                } else {
+                    runQueued(shard, queues[shard]);
+                }
+            });
+            if (options_.pin) {
+                pinThreadToCpu(workers.back(), static_cast<int>(shard % std::thread::hardware_concurrency()));
+            }
+        }
+        while (ready < threads_) {}
+
+        auto start = Clock::now();
+        go.store(true, std::memory_order_release);
+        if (!queues.empty()) {
+            produce(queues);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        return elapsedNs(start, Clock::now());
+    }
+
+    const std::vector<ShardStats>& stats() const { return stats_; }
+
+private:
+    const Options& options_;
+    const std::vector<SymbolEvent>& stream_;
+    std::string scenario_;
+    size_t threads_;
+    std::vector<OrderBook> books_;
+    std::vector<ShardStats> stats_;
+    std::unique_ptr<TradeLogger> logger_;
+    std::string log_path_;
+
+    void process(ShardStats& stats, uint32_t symbol, std::unique_ptr<Order> order, uint64_t cancel_id) {
+        auto start = Clock::now();
+        if (order) {
+            books_[symbol].processOrderSync(std::move(order));
+        } else {
+            books_[symbol].cancelOrderSync(cancel_id);
+        }
+        uint64_t ns = elapsedNs(start, Clock::now());
+        stats.latency.record(ns);
+        stats.busy_ns += ns;
+        stats.events++;
+    }
+
+    static std::unique_ptr<Order> makeOrder(const MarketEvent& event) {
+        if (event.type == EventType::CANCEL) {
+            return nullptr;
+        }
+        return std::make_unique<Order>(event.order_id, event.side, event.price, event.quantity);
+    }
+
+    void runDirect(size_t shard) {
+        ShardStats& stats = stats_[shard];
+        for (const auto& entry : stream_) {
+            if (entry.symbol % threads_ == shard) {
+                process(stats, entry.symbol, makeOrder(entry.event), entry.event.order_id);
+            }
+        }
+    }
+
+    void runQueued(size_t shard, ShardQueue& queue) {
+        ShardStats& stats = stats_[shard];
+        std::unique_lock<std::mutex> lock(queue.mutex);
+        while (true) {
+            queue.cv.wait(lock, [&] { return !queue.requests.empty() || queue.done; });
+            if (queue.requests.empty()) {
+                return;
+            }
+            auto request = std::move(queue.requests.front());
+            queue.requests.pop_front();
+            lock.unlock();
+            process(stats, request.symbol, std::move(request.order), request.cancel_id);
+            lock.lock();
+        }
+    }
+
+    void produce(std::vector<ShardQueue>& queues) {
+        for (const auto& entry : stream_) {
+            ShardQueue& queue = queues[entry.symbol % threads_];
+            auto order = makeOrder(entry.event);
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.requests.push_back({entry.symbol, std::move(order), entry.event.order_id});
+            queue.cv.notify_one();
+        }
+        for (auto& queue : queues) {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.done = true;
+            queue.cv.notify_one();
+        }
+    }
+};
+
+std::vector<size_t> parseList(const std::string& list) {
+    std::vector<size_t> values;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        values.push_back(std::stoull(item));
+    }
+    return values;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (options.output.parse(arg)) {
+                continue;
+            } else if (arg.rfind("--books=", 0) == 0) {
+                options.books = std::max<size_t>(std::stoull(arg.substr(8)), 1);
+            } else if (arg.rfind("--events=", 0) == 0) {
+                options.events = std::stoull(arg.substr(9));
+            } else if (arg.rfind("--threads=", 0) == 0) {
+                options.threads = parseList(arg.substr(10));
+            } else if (arg == "--skew=uniform" || arg == "--skew=zipf") {
+                options.zipf = arg == "--skew=zipf";
+            } else if (arg.rfind("--zipf-s=", 0) == 0) {
+                options.zipf_s = std::stod(arg.substr(9));
+            } else if (arg.rfind("--scenarios=", 0) == 0) {
+                options.scenarios.clear();
+                std::stringstream list(arg.substr(12));
+                std::string item;
+                while (std::getline(list, item, ',')) {
+                    if (item != "matching" && item != "ingress" && item != "logger") {
+                        throw std::invalid_argument(item);
+                    }
+                    options.scenarios.push_back(item);
+                }
+            } else if (arg == "--pin") {
+                options.pin = true;
+            } else if (arg.rfind("--log-dir=", 0) == 0) {
+                options.log_dir = arg.substr(10);
+            } else {
+                throw std::invalid_argument(arg);
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Usage: " << argv[0] << " [--books=K] [--events=N] [--threads=N,N,...]\n"
+                  << "  [--skew=uniform|zipf] [--zipf-s=S] [--scenarios=matching,ingress,logger]\n"
+                  << "  [--pin] [--log-dir=DIR] [--format=table|json] [--out=FILE]\n";
+        return 2;
+    }
+    if (options.threads.empty()) {
+        size_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+        for (size_t threads = 1; threads < cores; threads *= 2) {
+            options.threads.push_back(threads);
+        }
+        options.threads.push_back(cores);
+    }
+
+    std::vector<SymbolEvent> stream = generateStream(options);
+    std::string skew = options.zipf ? "zipf" + std::to_string(options.zipf_s).substr(0, 4) : "uniform";
+
+    BenchReporter reporter;
+    for (const auto& scenario : options.scenarios) {
+        double single_thread_rate = 0.0;
+        for (size_t threads : options.threads) {
+            threads = std::clamp<size_t>(threads, 1, options.books);
+            ScalingRun run(options, stream, scenario, threads);
+            uint64_t wall_ns = run.run();
+
+            std::vector<std::pair<std::string, std::string>> params = {
+                {"scenario", scenario}, {"skew", skew},
+                {"books", std::to_string(options.books)}, {"threads", std::to_string(threads)}};
+            LatencyHistogram merged;
+            uint64_t hottest = 0;
+            uint64_t worst_p99 = 0;
+            uint64_t trades = 0;
+            for (size_t shard = 0; shard < threads; ++shard) {
+                const ShardStats& stats = run.stats()[shard];
+                merged.merge(stats.latency);
+                hottest = std::max(hottest, stats.events);
+                worst_p99 = std::max(worst_p99, stats.latency.getPercentile(99.0));
+                trades += stats.trades;
+
+                BenchResult shard_result;
+                shard_result.suite = "scaling";
+                shard_result.name = "shard";
+                shard_result.params = params;
+                shard_result.params.emplace_back("shard", std::to_string(shard));
+                shard_result.ops = stats.events;
+                shard_result.total_ns = stats.busy_ns;
+                shard_result.setPercentiles(stats.latency);
+                shard_result.extra = {{"utilization", wall_ns > 0 ? static_cast<double>(stats.busy_ns) / wall_ns : 0.0}};
+                reporter.add(std::move(shard_result));
+            }
+
+            double rate = wall_ns > 0 ? stream.size() * 1e9 / wall_ns : 0.0;
+            if (threads == 1) {
+                single_thread_rate = rate;
+            }
+            BenchResult aggregate;
+            aggregate.suite = "scaling";
+            aggregate.name = "aggregate";
+            aggregate.params = params;
+            aggregate.ops = stream.size();
+            aggregate.total_ns = wall_ns;
+            aggregate.setPercentiles(merged);
+            // Efficiency needs a measured one-thread rate, so only once --threads has included 1
+            if (single_thread_rate > 0) {
+                aggregate.extra.emplace_back("efficiency", rate / (threads * single_thread_rate));
+            }
+            aggregate.extra.emplace_back("hot_shard_share", static_cast<double>(hottest) / stream.size());
+            aggregate.extra.emplace_back("worst_shard_p99_ns", static_cast<double>(worst_p99));
+            aggregate.extra.emplace_back("trades", static_cast<double>(trades));
+            reporter.add(std::move(aggregate));
+        }
+    }
+    return options.output.write(reporter) ? 0 : 1;
+}
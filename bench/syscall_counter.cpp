@@ -0,0 +1,77 @@
+#include "syscall_counter.hpp"
+#include "perf_event.hpp"
+#include <fstream>
+#include <string>
+#include <sys/resource.h>
+
+namespace OrderEngine {
+
+static int syscallTracepointId() {
+    const char* paths[] = {
+        "/sys/kernel/tracing/events/raw_syscalls/sys_enter/id",
+        "/sys/kernel/debug/tracing/events/raw_syscalls/sys_enter/id",
+    };
+    for (const char* path : paths) {
+        std::ifstream file(path);
+        int id = -1;
+        if (file >> id) {
+            return id;
+        }
+    }
+    return -1;
+}
+
+SyscallCounter::SyscallCounter() {
+    int id = syscallTracepointId();
+    if (id >= 0) {
+        fd_ = openPerfEvent(PERF_TYPE_TRACEPOINT, static_cast<uint64_t>(id));
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+    
+    // Reading the counter makes syscalls of its own; measure them once
+    uint64_t first = readRaw();
+    uint64_t second = readRaw();
+    read_overhead_ = second - first;
+}
+
+SyscallCounter::~SyscallCounter() {
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+}
+
+uint64_t SyscallCounter::read() {
+    uint64_t raw = readRaw();
+    uint64_t overhead = read_overhead_ * reads_++;
+    return raw > overhead ? raw - overhead : 0;
+}
+
+const char* SyscallCounter::source() const {
+    return fd_ >= 0 ? "raw_syscalls:sys_enter" : "proc io syscr/syscw + voluntary csw (partial)";
+}
+
+uint64_t SyscallCounter::readRaw() const {
+    if (fd_ >= 0) {
+        return readPerfEvent(fd_);
+    }
+    
+    uint64_t count = 0;
+    std::ifstream io("/proc/thread-self/io");
+    std::string key;
+    uint64_t value = 0;
+    while (io >> key >> value) {
+        if (key == "syscr:" || key == "syscw:") {
+            count += value;
+        }
+    }
+    rusage usage{};
+    if (getrusage(RUSAGE_THREAD, &usage) == 0) {
+        count += static_cast<uint64_t>(usage.ru_nvcsw);
+    }
+    return count;
+}
+
+} // namespace OrderEngine
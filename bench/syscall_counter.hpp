@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+namespace OrderEngine {
+
+// Counts syscalls made by the calling thread. Uses the raw_syscalls:sys_enter
+// tracepoint when tracefs and perf_event_open allow it; otherwise falls back to
+// read/write syscalls from /proc/thread-self/io plus voluntary context switches,
+// which catches I/O and blocking waits but not every syscall.
+class SyscallCounter {
+public:
+    SyscallCounter();
+    ~SyscallCounter();
+    
+    SyscallCounter(const SyscallCounter&) = delete;
+    SyscallCounter& operator=(const SyscallCounter&) = delete;
+    
+    // Cumulative count, corrected for the cost of reading it
+    uint64_t read();
+    bool isExact() const { return fd_ >= 0; }
+    const char* source() const;
+    
+private:
+    int fd_{-1};
+    uint64_t read_overhead_{0};
+    uint64_t reads_{0};
+    
+    uint64_t readRaw() const;
+};
+
+} // namespace OrderEngine
@@ -0,0 +1,542 @@
+#include "book_fuzz.hpp"
+#include "basic_order_book.hpp"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <unordered_map>
+
+namespace OrderEngine {
+
+namespace {
+
+constexpr uint32_t kPriceLevels = 32;
+constexpr uint32_t kMaxTargetBack = 64;
+constexpr uint32_t kMaxNudge = 4;
+
+double priceOf(uint32_t ticks) {
+    return (10000 + ticks) / 100.0;
+}
+
+// priceOf(ticks) moved nudge ulps towards the other side: far inside the
+// tick table's tolerance, so still the same tick to a by-tick store
+double nudgedPriceOf(uint32_t ticks, uint32_t nudge, OrderSide side) {
+    double price = priceOf(ticks);
+    double towards = side == OrderSide::BUY ? HUGE_VAL : -HUGE_VAL;
+    for (uint32_t i = 0; i < nudge; ++i) {
+        price = std::nextafter(price, towards);
+    }
+    return price;
+}
+
+// The grid price of the tick a by-tick variant reported a spelling of
+double tickPriceOf(double price) {
+    return std::round(price * 100) / 100.0;
+}
+
+std::optional<double> tickPriceOf(const std::optional<double>& price) {
+    return price ? std::optional<double>(tickPriceOf(*price)) : std::nullopt;
+}
+
+class ReferenceBook : public BookUnderTest {
+public:
+    void submit(uint64_t id, OrderSide side, double price, uint32_t quantity) override {
+        resting_.push_back({id, side, price, quantity, next_seq_++});
+        // Best bid against best ask until they no longer cross; the trade is
+        // priced at the sell order, whichever side was the aggressor
+        while (true) {
+            auto buy = best(OrderSide::BUY);
+            auto sell = best(OrderSide::SELL);
+            if (buy == resting_.end() || sell == resting_.end() || buy->price < sell->price) {
+                break;
+            }
+            uint32_t fill = std::min(buy->quantity, sell->quantity);
+            fills_.push_back({buy->id, sell->id, sell->price, fill});
+            buy->quantity -= fill;
+            sell->quantity -= fill;
+            resting_.erase(std::remove_if(resting_.begin(), resting_.end(),
+                                          [](const Resting& order) { return order.quantity == 0; }),
+                           resting_.end());
+        }
+    }
+    
+    bool cancel(uint64_t id) override {
+        auto it = std::find_if(resting_.begin(), resting_.end(),
+                               [id](const Resting& order) { return order.id == id; });
+        if (it == resting_.end()) {
+            return false;
+        }
+        resting_.erase(it);
+        return true;
+    }
+    
+    std::optional<double> bestBid() const override { return bestPrice(OrderSide::BUY); }
+    std::optional<double> bestAsk() const override { return bestPrice(OrderSide::SELL); }
+    
+    size_t orderCount(OrderSide side) const override {
+        return std::count_if(resting_.begin(), resting_.end(),
+                             [side](const Resting& order) { return order.side == side; });
+    }
+    
+private:
+    struct Resting {
+        uint64_t id;
+        OrderSide side;
+        double price;
+        uint32_t quantity;
+        uint64_t seq;
+    };
+    std::vector<Resting> resting_;
+    uint64_t next_seq_{0};
+    
+    // Better price first, then earlier arrival
+    static bool better(const Resting& a, const Resting& b) {
+        if (a.price != b.price) {
+            return a.side == OrderSide::BUY ? a.price > b.price : a.price < b.price;
+        }
+        return a.seq < b.seq;
+    }
+    
+    template<typename Orders>
+    static auto bestIn(Orders& resting, OrderSide side) {
+        auto result = resting.end();
+        for (auto it = resting.begin(); it != resting.end(); ++it) {
+            if (it->side == side && (result == resting.end() || better(*it, *result))) {
+                result = it;
+            }
+        }
+        return result;
+    }
+    
+    std::vector<Resting>::iterator best(OrderSide side) { return bestIn(resting_, side); }
+    
+    std::optional<double> bestPrice(OrderSide side) const {
+        auto it = bestIn(resting_, side);
+        return it == resting_.end() ? std::nullopt : std::optional<double>(it->price);
+    }
+};
+
+class OrderBookUnderTest : public BookUnderTest {
+public:
+    explicit OrderBookUnderTest(const OrderBookConfig& config = OrderBookConfig{}) : book_(config) {
+        book_.setTradeCallback([this](const Trade& trade) {
+            fills_.push_back({trade.buy_order_id, trade.sell_order_id, trade.price, trade.quantity});
+        });
+    }
+    
+    void submit(uint64_t id, OrderSide side, double price, uint32_t quantity) override {
+        book_.processOrderSync(std::make_unique<Order>(id, side, price, quantity));
+    }
+    bool cancel(uint64_t id) override { return book_.cancelOrderSync(id); }
+    std::optional<double> bestBid() const override { return book_.getBestBid(); }
+    std::optional<double> bestAsk() const override { return book_.getBestAsk(); }
+    size_t orderCount(OrderSide side) const override {
+        return side == OrderSide::BUY ? book_.getBuyOrdersCount() : book_.getSellOrdersCount();
+    }
+    
+private:
+    OrderBook book_;
+};
+
+// BasicOrderBook prices: integral ones count 0.0001 ticks, fine enough for the
+// quoting benchmark's prices too. Division is correctly rounded, so they
+// convert back to exactly the double priceOf() built.
+template<typename Price>
+double gridPrice(Price price) {
+    if constexpr (std::is_integral_v<Price>) {
+        return price / 10000.0;
+    } else {
+        return price;
+    }
+}
+
+// Records fills straight from the matching loop, with no std::function
+template<typename Trade>
+struct FillRecorder {
+    std::vector<Fill>* fills = nullptr;
+    
+    void onTrade(const Trade& trade) {
+        fills->push_back({trade.buy_order_id, trade.sell_order_id, gridPrice(trade.price), trade.quantity});
+    }
+};
+
+template<typename Book>
+class BasicBookUnderTest : public BookUnderTest {
+public:
+    using Price = typename Book::price_type;
+    
+    explicit BasicBookUnderTest(const typename Book::LevelConfig& config = {}) : book_(config) {
+        if constexpr (std::is_same_v<decltype(book_.listener()), FillRecorder<typename Book::Trade>&>) {
+            book_.listener().fills = &fills_;
+        } else {
+            book_.listener().callback = [this](const typename Book::Trade& trade) {
+                fills_.push_back({trade.buy_order_id, trade.sell_order_id, gridPrice(trade.price), trade.quantity});
+            };
+        }
+    }
+    
+    void submit(uint64_t id, OrderSide side, double price, uint32_t quantity) override {
+        book_.submit(id, side, toPrice(price), quantity);
+    }
+    bool cancel(uint64_t id) override { return book_.cancel(id); }
+    std::optional<double> bestBid() const override { return toDouble(book_.bestBid()); }
+    std::optional<double> bestAsk() const override { return toDouble(book_.bestAsk()); }
+    size_t orderCount(OrderSide side) const override { return book_.orderCount(side); }
+    
+private:
+    Book book_;
+    
+    static Price toPrice(double price) {
+        if constexpr (std::is_integral_v<Price>) {
+            return static_cast<Price>(std::llround(price * 10000));
+        } else {
+            return price;
+        }
+    }
+    static std::optional<double> toDouble(const std::optional<Price>& price) {
+        return price ? std::optional<double>(gridPrice(*price)) : std::nullopt;
+    }
+};
+
+// First broken allocation property seen by CheckedMatching in this run
+std::string allocation_failure;
+
+// A matching policy with no reference to diff against, checked on every
+// level it matches instead: the fills add up to min(incoming, level total),
+// no order gets more than it has resting, and a rerun over a copy of the
+// level shares it out the same way as the run that trades
+template<typename Matching>
+struct CheckedMatching {
+    template<typename Price, typename Quantity>
+    using Allocation = std::vector<std::pair<uint64_t, Quantity>>;
+
+    template<typename Price, typename Quantity, typename OnFill>
+    static Quantity match(LevelQueue<Price, Quantity>& level, Quantity quantity, OnFill&& on_fill) {
+        Allocation<Price, Quantity> first = allocate(level, quantity);
+        Allocation<Price, Quantity> second = allocate(level, quantity);
+        std::unordered_map<uint64_t, uint64_t> room;
+        uint64_t total = 0;
+        for (size_t i = level.head; i < level.ids.size(); ++i) {
+            room[level.ids[i]] += level.quantities[i];
+            total += level.quantities[i];
+        }
+        uint64_t filled = 0;
+        for (const auto& [id, share] : first) {
+            filled += share;
+            if (share > room[id]) {
+                fail("order " + std::to_string(id) + " got " + std::to_string(share) + " with " +
+                     std::to_string(room[id]) + " left resting");
+            }
+            room[id] -= std::min<uint64_t>(share, room[id]);
+        }
+        if (filled != std::min<uint64_t>(quantity, total)) {
+            fail("level of " + std::to_string(total) + " filled " + std::to_string(filled) + " of " +
+                 std::to_string(quantity));
+        }
+        if (first != second) {
+            fail("two runs over the same level allocated it differently");
+        }
+
+        Allocation<Price, Quantity> traded;
+        Quantity result = Matching::match(level, quantity, [&](uint64_t id, Quantity share, Quantity left) {
+            traded.emplace_back(id, share);
+            on_fill(id, share, left);
+        });
+        if (traded != first) {
+            fail("the level traded differently from its copy");
+        }
+        return result;
+    }
+
+    template<typename Price, typename Quantity>
+    static Allocation<Price, Quantity> allocate(const LevelQueue<Price, Quantity>& level, Quantity quantity) {
+        LevelQueue<Price, Quantity> copy = level;
+        Allocation<Price, Quantity> allocation;
+        Matching::match(copy, quantity, [&](uint64_t id, Quantity share, Quantity) { allocation.emplace_back(id, share); });
+        return allocation;
+    }
+
+    static void fail(const std::string& detail) {
+        if (allocation_failure.empty()) {
+            allocation_failure = detail;
+        }
+    }
+};
+
+// A 0.0001 tick puts the fuzz grid's 0.01 levels 100 slots apart, so the
+// occupancy bitmap is searched across words; the window covers any first order
+OrderBookConfig ladderConfig() {
+    OrderBookConfig config;
+    config.level_store = LevelStoreType::LADDER;
+    config.ladder.tick_size = 0.0001;
+    config.ladder.levels = 8192;
+    return config;
+}
+
+std::string formatFill(const Fill& fill) {
+    std::ostringstream out;
+    out << fill.buy_order_id << "/" << fill.sell_order_id << " " << fill.quantity << "@" << fill.price;
+    return out.str();
+}
+
+std::string formatPrice(const std::optional<double>& price) {
+    if (!price) {
+        return "none";
+    }
+    std::ostringstream out;
+    out << *price;
+    return out.str();
+}
+
+// Empty if the variant agrees with the reference; by-tick variants' prices
+// are compared by tick
+std::string compareBooks(const BookUnderTest& reference, const BookUnderTest& variant, bool by_tick,
+                         const std::vector<Fill>& reference_fills, std::vector<Fill> variant_fills,
+                         bool reference_hit, bool variant_hit) {
+    auto bestBid = [&] { return by_tick ? tickPriceOf(variant.bestBid()) : variant.bestBid(); };
+    auto bestAsk = [&] { return by_tick ? tickPriceOf(variant.bestAsk()) : variant.bestAsk(); };
+    if (by_tick) {
+        for (auto& fill : variant_fills) {
+            fill.price = tickPriceOf(fill.price);
+        }
+    }
+    std::ostringstream detail;
+    if (reference_hit != variant_hit) {
+        detail << "cancel result " << variant_hit << ", expected " << reference_hit;
+    } else if (reference_fills != variant_fills) {
+        detail << "fills [";
+        for (const auto& fill : variant_fills) detail << " " << formatFill(fill);
+        detail << " ], expected [";
+        for (const auto& fill : reference_fills) detail << " " << formatFill(fill);
+        detail << " ]";
+    } else if (reference.bestBid() != bestBid() || reference.bestAsk() != bestAsk()) {
+        detail << "top of book " << formatPrice(bestBid()) << " x " << formatPrice(bestAsk())
+               << ", expected " << formatPrice(reference.bestBid()) << " x " << formatPrice(reference.bestAsk());
+    } else if (reference.orderCount(OrderSide::BUY) != variant.orderCount(OrderSide::BUY) ||
+               reference.orderCount(OrderSide::SELL) != variant.orderCount(OrderSide::SELL)) {
+        detail << "resting orders " << variant.orderCount(OrderSide::BUY) << "/"
+               << variant.orderCount(OrderSide::SELL) << ", expected "
+               << reference.orderCount(OrderSide::BUY) << "/" << reference.orderCount(OrderSide::SELL);
+    }
+    return detail.str();
+}
+
+} // namespace
+
+std::string FuzzOp::describe(uint64_t new_id) const {
+    std::ostringstream out;
+    switch (type) {
+    case FuzzOpType::NEW:
+        out << "new " << (side == OrderSide::BUY ? "buy" : "sell") << " id=" << new_id
+            << " price=" << priceOf(price_ticks) << " qty=" << quantity;
+        break;
+    case FuzzOpType::CANCEL:
+        out << "cancel id=" << target_id;
+        break;
+    case FuzzOpType::AMEND:
+        out << "amend id=" << target_id << " -> id=" << new_id
+            << " price=" << priceOf(price_ticks) << " qty=" << quantity;
+        break;
+    }
+    if (type != FuzzOpType::CANCEL && nudge != 0) {
+        out << " (" << nudge << " ulp off the grid by tick)";
+    }
+    return out.str();
+}
+
+std::vector<FuzzOp> decodeFuzzInput(const uint8_t* data, size_t size) {
+    std::vector<FuzzOp> ops;
+    ops.reserve(size / kFuzzOpBytes);
+    uint64_t issued = 0;  // Ids handed out so far: new orders and amend replacements
+    for (size_t i = 0; i + kFuzzOpBytes <= size; i += kFuzzOpBytes) {
+        const uint8_t* bytes = data + i;
+        FuzzOp op;
+        uint8_t selector = bytes[0] % 8;
+        op.type = selector < 6 ? FuzzOpType::NEW : selector == 6 ? FuzzOpType::CANCEL : FuzzOpType::AMEND;
+        op.side = bytes[1] & 0x80 ? OrderSide::SELL : OrderSide::BUY;
+        op.price_ticks = bytes[1] % kPriceLevels;
+        op.nudge = (bytes[0] >> 3) % kMaxNudge;
+        op.quantity = 1 + bytes[2];
+        // Mostly recent ids; a step back of 0 names the next, not yet issued, id
+        uint64_t back = bytes[3] % kMaxTargetBack;
+        op.target_id = back <= issued ? issued + 1 - back : issued + 1 + back;
+        issued += op.type != FuzzOpType::CANCEL;
+        ops.push_back(op);
+    }
+    return ops;
+}
+
+std::unique_ptr<BookUnderTest> makeReferenceBook() {
+    return std::make_unique<ReferenceBook>();
+}
+
+const std::vector<BookVariant>& bookVariants() {
+    static const std::vector<BookVariant> variants = {
+        {"OrderBook", [] { return std::make_unique<OrderBookUnderTest>(); }},
+        {"OrderBook/ladder", [] { return std::make_unique<OrderBookUnderTest>(ladderConfig()); }, true},
+        {"OrderBook/sorted", [] {
+            OrderBookConfig config;
+            config.level_store = LevelStoreType::SORTED;
+            return std::make_unique<OrderBookUnderTest>(config);
+        }},
+        {"OrderBook/tiered", [] {
+            // The window spans about 5 of the grid's 32 levels, so levels are
+            // demoted and promoted constantly
+            OrderBookConfig config;
+            config.level_store = LevelStoreType::TIERED;
+            config.tiered.tick_size = 0.0001;
+            config.tiered.window = 512;
+            return std::make_unique<OrderBookUnderTest>(config);
+        }, true},
+        {"OrderBook/ladder-recenter", [] {
+            // About 3 grid levels fit the window, so it is always moving
+            // and most levels pass through the overflow
+            OrderBookConfig config = ladderConfig();
+            config.ladder.levels = 256;
+            config.ladder.recenter_step = 16;
+            return std::make_unique<OrderBookUnderTest>(config);
+        }, true},
+        {"OrderBook/ladder-banded", [] {
+            // Fine ticks below the middle of the grid, its own 0.01 above, so
+            // matches and depth cross a band boundary
+            OrderBookConfig config = ladderConfig();
+            config.ladder.tick_table = TickTable{{0, 0.0001}, {priceOf(kPriceLevels / 2), 0.01}};
+            config.ladder.levels = 4096;
+            return std::make_unique<OrderBookUnderTest>(config);
+        }, true},
+        {"BasicOrderBook", [] { return std::make_unique<BasicBookUnderTest<BasicOrderBook<>>>(); }},
+        {"BasicOrderBook/ticks-dense-inline", [] {
+            using Book = BasicOrderBook<int32_t, uint32_t, LadderLevelStore, FifoMatching,
+                                        FillRecorder<BasicTrade<int32_t, uint32_t>>>;
+            // 99.5 to 101.1: the fuzz grid and the quoting benchmark's band
+            LadderConfig ladder;
+            ladder.levels = 16384;
+            ladder.base_price = 995000;
+            return std::make_unique<BasicBookUnderTest<Book>>(ladder);
+        }, true},
+    };
+    return variants;
+}
+
+const std::vector<BookVariant>& proRataVariants() {
+    static const std::vector<BookVariant> variants = {
+        {"BasicOrderBook/pro-rata", [] {
+            using Book = BasicOrderBook<double, uint32_t, TreeLevelStore, CheckedMatching<ProRataMatching<>>>;
+            return std::make_unique<BasicBookUnderTest<Book>>();
+        }},
+        {"BasicOrderBook/pro-rata-top-sorted", [] {
+            using Book = BasicOrderBook<double, uint32_t, SortedLevelStore, CheckedMatching<ProRataMatching<true>>>;
+            return std::make_unique<BasicBookUnderTest<Book>>();
+        }},
+    };
+    return variants;
+}
+
+std::optional<Divergence> runDifferential(const std::vector<FuzzOp>& ops) {
+    auto reference = makeReferenceBook();
+    std::vector<std::unique_ptr<BookUnderTest>> books;
+    for (const auto& variant : bookVariants()) {
+        books.push_back(variant.create());
+    }
+    std::vector<std::unique_ptr<BookUnderTest>> pro_rata;
+    for (const auto& variant : proRataVariants()) {
+        pro_rata.push_back(variant.create());
+    }
+    allocation_failure.clear();
+    
+    std::unordered_map<uint64_t, OrderSide> sides;
+    uint64_t next_id = 1;
+    std::vector<bool> hits(books.size());
+    for (size_t i = 0; i < ops.size(); ++i) {
+        const FuzzOp& op = ops[i];
+        const uint64_t new_id = next_id;  // For a new order or an amend's replacement
+        bool reference_hit = false;
+        std::fill(hits.begin(), hits.end(), false);
+        OrderSide side = op.side;
+        
+        if (op.type != FuzzOpType::NEW) {
+            reference_hit = reference->cancel(op.target_id);
+            for (size_t b = 0; b < books.size(); ++b) {
+                hits[b] = books[b]->cancel(op.target_id);
+            }
+            auto known = sides.find(op.target_id);
+            if (known != sides.end()) {
+                side = known->second;  // Replacements keep the original side
+            }
+        }
+        if (op.type == FuzzOpType::NEW || (op.type == FuzzOpType::AMEND && reference_hit)) {
+            sides[new_id] = side;
+            reference->submit(new_id, side, priceOf(op.price_ticks), op.quantity);
+            for (size_t b = 0; b < books.size(); ++b) {
+                double price = bookVariants()[b].by_tick ? nudgedPriceOf(op.price_ticks, op.nudge, side)
+                                                         : priceOf(op.price_ticks);
+                books[b]->submit(new_id, side, price, op.quantity);
+            }
+        }
+        next_id += op.type != FuzzOpType::CANCEL;
+        
+        std::vector<Fill> reference_fills = reference->takeFills();
+        for (size_t b = 0; b < books.size(); ++b) {
+            std::string detail = compareBooks(*reference, *books[b], bookVariants()[b].by_tick, reference_fills,
+                                              books[b]->takeFills(), reference_hit, hits[b]);
+            if (!detail.empty()) {
+                return Divergence{bookVariants()[b].name, i, detail};
+            }
+        }
+        
+        // The pro-rata books trade differently, so they replace on their own cancel result
+        for (size_t b = 0; b < pro_rata.size(); ++b) {
+            bool hit = op.type != FuzzOpType::NEW && pro_rata[b]->cancel(op.target_id);
+            if (op.type == FuzzOpType::NEW || (op.type == FuzzOpType::AMEND && hit)) {
+                pro_rata[b]->submit(new_id, side, priceOf(op.price_ticks), op.quantity);
+            }
+            pro_rata[b]->takeFills();
+            if (!allocation_failure.empty()) {
+                return Divergence{proRataVariants()[b].name, i, allocation_failure};
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<uint8_t> minimizeDivergence(std::vector<uint8_t> input) {
+    input.resize(input.size() / kFuzzOpBytes * kFuzzOpBytes);
+    auto diverges = [](const std::vector<uint8_t>& candidate) {
+        return runDifferential(decodeFuzzInput(candidate.data(), candidate.size())).has_value();
+    };
+    
+    // Delta debugging over whole ops: drop chunks, halving the chunk size
+    // whenever no chunk of the current size can go
+    size_t chunk = std::max<size_t>(input.size() / kFuzzOpBytes / 2, 1);
+    while (true) {
+        bool removed = false;
+        for (size_t start = 0; start < input.size(); ) {
+            size_t end = std::min(input.size(), start + chunk * kFuzzOpBytes);
+            std::vector<uint8_t> candidate(input.begin(), input.begin() + start);
+            candidate.insert(candidate.end(), input.begin() + end, input.end());
+            if (!candidate.empty() && diverges(candidate)) {
+                input = std::move(candidate);
+                removed = true;
+            } else {
+                start = end;
+            }
+        }
+        if (chunk == 1 && !removed) {
+            break;
+        }
+        chunk = std::max<size_t>(chunk / 2, 1);
+    }
+    return input;
+}
+
+std::string describeFuzzInput(const std::vector<uint8_t>& input) {
+    std::ostringstream out;
+    uint64_t next_id = 1;
+    auto ops = decodeFuzzInput(input.data(), input.size());
+    for (size_t i = 0; i < ops.size(); ++i) {
+        out << "#" << i << " " << ops[i].describe(next_id) << "\n";
+        next_id += ops[i].type != FuzzOpType::CANCEL;
+    }
+    return out.str();
+}
+
+} // namespace OrderEngine
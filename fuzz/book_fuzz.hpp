@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "order_book.hpp"
+
+namespace OrderEngine {
+
+// Differential fuzzing of book implementations. A fuzz input is decoded into
+// a sequence of operations that is run through a simple reference book and
+// every registered variant; fills, cancel results and top of book are
+// compared after every operation. Pro-rata books, which have no reference,
+// run the same operations under per-level property checks. Variants that rest
+// orders by tick also see prices a few ulps off the grid, as a client's
+// arithmetic produces them, and must treat each spelling as its tick.
+
+enum class FuzzOpType : uint8_t { NEW, CANCEL, AMEND };
+
+struct FuzzOp {
+    FuzzOpType type;
+    OrderSide side;
+    uint32_t price_ticks;  // Offset on a small tick grid, so prices collide
+    uint32_t nudge;        // Ulps off the grid for by-tick variants; 0 is exact
+    uint32_t quantity;
+    uint64_t target_id;    // Cancel/amend target: live, filled or never-seen ids
+    
+    std::string describe(uint64_t new_id) const;
+};
+
+// Each operation takes kFuzzOpBytes input bytes; a trailing partial op is ignored
+constexpr size_t kFuzzOpBytes = 4;
+std::vector<FuzzOp> decodeFuzzInput(const uint8_t* data, size_t size);
+
+struct Fill {
+    uint64_t buy_order_id;
+    uint64_t sell_order_id;
+    double price;
+    uint32_t quantity;
+    
+    bool operator==(const Fill& other) const {
+        return buy_order_id == other.buy_order_id && sell_order_id == other.sell_order_id &&
+               price == other.price && quantity == other.quantity;
+    }
+};
+
+// What the harness drives. Amend is cancel/replace: the order loses its
+// priority and comes back under a new id, as a client would do today.
+class BookUnderTest {
+public:
+    virtual ~BookUnderTest() = default;
+    virtual void submit(uint64_t id, OrderSide side, double price, uint32_t quantity) = 0;
+    virtual bool cancel(uint64_t id) = 0;
+    virtual std::optional<double> bestBid() const = 0;
+    virtual std::optional<double> bestAsk() const = 0;
+    virtual size_t orderCount(OrderSide side) const = 0;
+    
+    // Fills produced since the last call
+    std::vector<Fill> takeFills() { return std::move(fills_); }
+    
+protected:
+    std::vector<Fill> fills_;
+};
+
+struct BookVariant {
+    std::string name;
+    std::function<std::unique_ptr<BookUnderTest>()> create;
+    // Rests orders by tick: fed nudged prices (buys up, sells down, so a
+    // spelling never stops two orders at one tick crossing) and compared with
+    // the reference's prices by tick
+    bool by_tick = false;
+};
+
+// The reference: a flat list of resting orders scanned in full for every
+// decision. Slow, but its price-time rules can be read off at a glance.
+std::unique_ptr<BookUnderTest> makeReferenceBook();
+
+// Implementations checked against the reference; new book structures are added here
+const std::vector<BookVariant>& bookVariants();
+
+// Pro-rata books, which share a level out differently from the reference's
+// price-time rule. They run the same operations, and every level they match
+// is checked for the properties of a pro-rata allocation instead: fills that
+// add up to min(incoming, level total), no share above an order's resting
+// size, and the same allocation on a rerun.
+const std::vector<BookVariant>& proRataVariants();
+
+struct Divergence {
+    std::string variant;
+    size_t op_index;
+    std::string detail;
+};
+
+// Runs ops through the reference and every variant, and through the pro-rata
+// books; returns the first mismatch or broken allocation property
+std::optional<Divergence> runDifferential(const std::vector<FuzzOp>& ops);
+
+// Shrinks a diverging input by dropping runs of ops while it still diverges
+std::vector<uint8_t> minimizeDivergence(std::vector<uint8_t> input);
+
+// Human-readable listing of the operations in an input
+std::string describeFuzzInput(const std::vector<uint8_t>& input);
+
+} // namespace OrderEngine
@@ -0,0 +1,92 @@
+// Standalone driver for the differential book fuzzer, for builds without
+// libFuzzer. Runs seeded random inputs, or replays the given input files
+// (libFuzzer crash files and corpus entries work as-is). A divergence is
+// minimized and written out as a reproducer.
+//
+//   ./order_book_fuzz [--runs=N] [--seed=N] [--max-ops=N]
+//   ./order_book_fuzz FILE...            replay, minimize and explain
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include "book_fuzz.hpp"
+
+using namespace OrderEngine;
+
+namespace {
+
+// Minimizes, prints and saves a diverging input
+void reportDivergence(const std::vector<uint8_t>& input, const std::string& out_path) {
+    std::vector<uint8_t> minimized = minimizeDivergence(input);
+    auto divergence = runDifferential(decodeFuzzInput(minimized.data(), minimized.size()));
+    std::cerr << divergence->variant << " diverged at op " << divergence->op_index
+              << ": " << divergence->detail << "\n"
+              << "Minimized from " << input.size() / kFuzzOpBytes << " to "
+              << minimized.size() / kFuzzOpBytes << " ops:\n" << describeFuzzInput(minimized);
+    std::ofstream out(out_path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(minimized.data()), static_cast<std::streamsize>(minimized.size()));
+    std::cerr << "Reproducer written to " << out_path << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint64_t runs = 10000;
+    uint64_t seed = 1;
+    size_t max_ops = 200;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--runs=", 0) == 0) {
+            runs = std::stoull(arg.substr(7));
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            seed = std::stoull(arg.substr(7));
+        } else if (arg.rfind("--max-ops=", 0) == 0) {
+            max_ops = std::max<size_t>(std::stoull(arg.substr(10)), 1);
+        } else if (arg.rfind("--", 0) != 0) {
+            files.push_back(arg);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--runs=N] [--seed=N] [--max-ops=N] [FILE...]\n";
+            return 2;
+        }
+    }
+    
+    std::cerr << "Checking " << bookVariants().size() << " variant(s) against the reference and "
+              << proRataVariants().size() << " pro-rata variant(s) for allocation properties\n";
+    if (!files.empty()) {
+        for (const auto& path : files) {
+            std::ifstream in(path, std::ios::binary);
+            if (!in) {
+                std::cerr << "Cannot open " << path << "\n";
+                return 2;
+            }
+            std::vector<uint8_t> input((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            if (runDifferential(decodeFuzzInput(input.data(), input.size()))) {
+                reportDivergence(input, path + ".min");
+                return 1;
+            }
+        }
+        std::cerr << files.size() << " input(s) agree\n";
+        return 0;
+    }
+    
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<size_t> ops_dist(1, max_ops);
+    std::uniform_int_distribution<int> byte_dist(0, 255);
+    uint64_t total_ops = 0;
+    for (uint64_t run = 0; run < runs; ++run) {
+        std::vector<uint8_t> input(ops_dist(rng) * kFuzzOpBytes);
+        for (auto& byte : input) {
+            byte = static_cast<uint8_t>(byte_dist(rng));
+        }
+        total_ops += input.size() / kFuzzOpBytes;
+        if (runDifferential(decodeFuzzInput(input.data(), input.size()))) {
+            reportDivergence(input, "divergence-" + std::to_string(seed) + "-" + std::to_string(run) + ".bin");
+            return 1;
+        }
+    }
+    std::cerr << runs << " runs, " << total_ops << " ops: no divergence\n";
+    return 0;
+}
@@ -0,0 +1,17 @@
+// libFuzzer entry point for the differential book fuzzer. Build with
+// -DOE_LIBFUZZER=ON using clang; a divergence aborts so libFuzzer saves the
+// input (shrink it with -minimize_crash=1, or with order_book_fuzz FILE).
+#include <cstdio>
+#include <cstdlib>
+#include "book_fuzz.hpp"
+
+using namespace OrderEngine;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    if (auto divergence = runDifferential(decodeFuzzInput(data, size))) {
+        std::fprintf(stderr, "%s diverged at op %zu: %s\n", divergence->variant.c_str(),
+                     divergence->op_index, divergence->detail.c_str());
+        std::abort();
+    }
+    return 0;
+}
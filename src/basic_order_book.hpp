@@ -0,0 +1,288 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "order.hpp"
+#include "level_store.hpp"
+
+namespace OrderEngine {
+
+// The matching core. Each of its choices is a template parameter, so every
+// combination compiles to its own straight-line code:
+//
+//   Price, Quantity   e.g. int32_t ticks in place of double prices
+//   Levels            per-side level store from level_store.hpp:
+//                     TreeLevelStore (any price), SortedLevelStore,
+//                     LadderLevelStore or TieredLevelStore
+//   Matching          how an incoming order is shared out within a level:
+//                     FifoMatching (price-time) or ProRataMatching
+//   Listener          gets every trade: CallbackListener (std::function) or
+//                     any type with an onTrade() the compiler can inline
+//
+// BasicOrderBook<> is double prices, uint32_t quantities, a tree per side,
+// price-time priority and a trade callback, with trades priced at the sell
+// order. It is synchronous: OrderBook runs one instantiation per level store
+// behind its matching thread and queue.
+
+template<typename Price, typename Quantity>
+struct BasicTrade {
+    uint64_t buy_order_id;
+    uint64_t sell_order_id;
+    Price price;
+    Quantity quantity;
+};
+
+// Matching policies share out up to `quantity` of an incoming order within
+// one level, calling on_fill(resting_id, filled, left) for every resting
+// order that trades, and return the quantity filled. They must fill
+// something from a non-empty level, and pop the orders they fill completely.
+
+// Price-time priority: the earliest order at the level fills first
+struct FifoMatching {
+    template<typename Price, typename Quantity, typename OnFill>
+    static Quantity match(LevelQueue<Price, Quantity>& level, Quantity quantity, OnFill&& on_fill) {
+        Quantity filled = 0;
+        while (filled < quantity && !level.empty()) {
+            Quantity& resting = level.quantities[level.head];
+            Quantity take = std::min<Quantity>(resting, quantity - filled);
+            resting -= take;
+            filled += take;
+            on_fill(level.ids[level.head], take, resting);
+            if (resting == 0) {
+                level.popFront();
+            }
+        }
+        return filled;
+    }
+};
+
+// Pro-rata, as some futures venues match: the incoming quantity is shared
+// across the level in proportion to each order's size rather than by arrival.
+// Shares are rounded down in one pass over the level's quantity array that
+// the compiler vectorises: the ratio is a 32.32 fixed-point fraction, so a
+// share is a 32x32->64 multiply and a shift, never above the exact share.
+// The lots left by rounding go one at a time to the orders with room left,
+// earliest first, so the allocation is deterministic. With TopOrderPriority
+// the earliest order at the level fills first and only the rest is shared.
+template<bool TopOrderPriority = false>
+struct ProRataMatching {
+    template<typename Price, typename Quantity, typename OnFill>
+    static Quantity match(LevelQueue<Price, Quantity>& level, Quantity quantity, OnFill&& on_fill) {
+        static_assert(std::is_unsigned_v<Quantity> && sizeof(Quantity) <= 4,
+                      "pro-rata shares are computed in 32.32 fixed point");
+        Quantity filled = 0;
+        if (TopOrderPriority) {
+            Quantity& top = level.quantities[level.head];
+            Quantity take = std::min(top, quantity);
+            top -= take;
+            filled += take;
+            on_fill(level.ids[level.head], take, top);
+            if (top == 0) {
+                level.popFront();
+            }
+            if (filled == quantity || level.empty()) {
+                return filled;
+            }
+        }
+
+        Quantity wanted = quantity - filled;
+        const Quantity* sizes = level.quantities.data() + level.head;
+        size_t count = level.count();
+        uint64_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            total += sizes[i];
+        }
+        if (wanted >= total) {
+            // The whole level fills, so time order makes no difference
+            return filled + FifoMatching::match(level, wanted, on_fill);
+        }
+
+        std::vector<Quantity>& shares = scratch<Quantity>();
+        shares.resize(count);
+        uint64_t ratio = (static_cast<uint64_t>(wanted) << 32) / total;  // Below 2^32: wanted < total
+        uint64_t allocated = 0;
+        for (size_t i = 0; i < count; ++i) {
+            shares[i] = static_cast<Quantity>((sizes[i] * ratio) >> 32);
+            allocated += shares[i];
+        }
+        // The level has room for all of it: wanted < total
+        for (uint64_t remainder = wanted - allocated; remainder > 0;) {
+            for (size_t i = 0; i < count && remainder > 0; ++i) {
+                if (shares[i] < sizes[i]) {
+                    shares[i]++;
+                    remainder--;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            if (shares[i] > 0) {
+                Quantity& resting = level.quantities[level.head + i];
+                resting -= shares[i];
+                on_fill(level.ids[level.head + i], shares[i], resting);
+            }
+        }
+        level.compactFilled();
+        return quantity;
+    }
+
+private:
+    // Per-thread share array, reused so matching does not allocate
+    template<typename Quantity>
+    static std::vector<Quantity>& scratch() {
+        thread_local std::vector<Quantity> shares;
+        return shares;
+    }
+};
+
+// Trade listener over std::function, set after construction
+template<typename Trade>
+struct CallbackListener {
+    std::function<void(const Trade&)> callback;
+
+    void onTrade(const Trade& trade) {
+        if (callback) {
+            callback(trade);
+        }
+    }
+};
+
+// What the last submit traded against, for latency outlier context
+struct SweepStats {
+    uint32_t levels = 0;  // Distinct opposite-side price levels
+    uint32_t orders = 0;  // Resting orders
+};
+
+template<typename Price = double, typename Quantity = uint32_t,
+         template<typename, typename, OrderSide> class Levels = TreeLevelStore,
+         typename Matching = FifoMatching,
+         typename Listener = CallbackListener<BasicTrade<Price, Quantity>>>
+class BasicOrderBook {
+public:
+    using price_type = Price;
+    using quantity_type = Quantity;
+    using Trade = BasicTrade<Price, Quantity>;
+    using BuyLevels = Levels<Price, Quantity, OrderSide::BUY>;
+    using SellLevels = Levels<Price, Quantity, OrderSide::SELL>;
+    using LevelConfig = typename BuyLevels::Config;
+
+    explicit BasicOrderBook(const LevelConfig& config = LevelConfig{}, Listener listener = Listener{})
+        : buy_levels_(config), sell_levels_(config), listener_(std::move(listener)) {}
+
+    // Matches on arrival and rests the residual. False, with nothing traded,
+    // if the id is already resting or this Levels cannot rest the price: a
+    // second order under a resting id could never be told apart from it, and
+    // an unrestable one would lose its residual after trading.
+    bool submit(uint64_t id, OrderSide side, Price price, Quantity quantity) {
+        sweep_ = SweepStats{};
+        bool restable = side == OrderSide::BUY ? buy_levels_.accepts(price) : sell_levels_.accepts(price);
+        if (!restable || resting_.count(id) != 0) {
+            rejected_++;
+            return false;
+        }
+        if (side == OrderSide::BUY) {
+            return submitTo<OrderSide::BUY>(id, price, quantity, sell_levels_, buy_levels_);
+        }
+        return submitTo<OrderSide::SELL>(id, price, quantity, buy_levels_, sell_levels_);
+    }
+
+    // Removes a resting order; false if it is unknown or already filled
+    bool cancel(uint64_t id) {
+        auto it = resting_.find(id);
+        if (it == resting_.end()) {
+            return false;
+        }
+        bool cancelled = it->second.side == OrderSide::BUY ? buy_levels_.cancel(it->second.price, id)
+                                                           : sell_levels_.cancel(it->second.price, id);
+        if (cancelled) {
+            countOf(it->second.side)--;
+        }
+        resting_.erase(it);
+        return cancelled;
+    }
+
+    std::optional<Price> bestBid() const {
+        return buy_levels_.empty() ? std::nullopt : std::optional<Price>(buy_levels_.bestPrice());
+    }
+    std::optional<Price> bestAsk() const {
+        return sell_levels_.empty() ? std::nullopt : std::optional<Price>(sell_levels_.bestPrice());
+    }
+    size_t orderCount(OrderSide side) const { return side == OrderSide::BUY ? buy_count_ : sell_count_; }
+    // Orders refused for a resting id or a price the level store cannot hold
+    uint64_t rejectedCount() const { return rejected_; }
+    const SweepStats& lastSweep() const { return sweep_; }
+
+    // Levels from the touch outwards (max_levels 0 = all)
+    std::vector<PriceLevel> depth(OrderSide side, size_t max_levels = 0) const {
+        std::vector<PriceLevel> levels;
+        if (side == OrderSide::BUY) {
+            buy_levels_.appendDepth(levels, max_levels);
+        } else {
+            sell_levels_.appendDepth(levels, max_levels);
+        }
+        return levels;
+    }
+
+    const BuyLevels& buyLevels() const { return buy_levels_; }
+    const SellLevels& sellLevels() const { return sell_levels_; }
+    Listener& listener() { return listener_; }
+
+private:
+    struct Resting {
+        OrderSide side;
+        Price price;
+    };
+
+    BuyLevels buy_levels_;
+    SellLevels sell_levels_;
+    Listener listener_;
+    std::unordered_map<uint64_t, Resting> resting_;  // Order id -> where it rests, for cancels
+    size_t buy_count_{0};
+    size_t sell_count_{0};
+    uint64_t rejected_{0};
+    SweepStats sweep_;
+
+    size_t& countOf(OrderSide side) { return side == OrderSide::BUY ? buy_count_ : sell_count_; }
+
+    template<OrderSide Side, typename Passive, typename Own>
+    bool submitTo(uint64_t id, Price price, Quantity quantity, Passive& passive, Own& own) {
+        while (quantity > 0 && !passive.empty() &&
+               (Side == OrderSide::BUY ? price >= passive.bestPrice() : price <= passive.bestPrice())) {
+            Price level_price = passive.bestPrice();
+            auto& level = passive.bestLevel();
+            sweep_.levels++;
+            quantity -= Matching::match(level, quantity, [&](uint64_t resting_id, Quantity filled, Quantity left) {
+                sweep_.orders++;
+                if (Side == OrderSide::BUY) {
+                    listener_.onTrade(Trade{id, resting_id, level_price, filled});
+                } else {
+                    listener_.onTrade(Trade{resting_id, id, price, filled});
+                }
+                if (left == 0) {
+                    resting_.erase(resting_id);
+                    countOf(Side == OrderSide::BUY ? OrderSide::SELL : OrderSide::BUY)--;
+                }
+            });
+            if (level.empty()) {
+                passive.popBestLevel();
+            }
+        }
+        if (quantity == 0) {
+            return true;
+        }
+        if (!own.add(price, id, quantity)) {
+            rejected_++;
+            return false;
+        }
+        resting_.emplace(id, Resting{Side, price});
+        countOf(Side)++;
+        return true;
+    }
+};
+
+} // namespace OrderEngine
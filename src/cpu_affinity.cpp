@@ -0,0 +1,48 @@
+#include "cpu_affinity.hpp"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <pthread.h>
+#include <sched.h>
+
+namespace OrderEngine {
+
+bool pinThreadToCpu(std::thread& thread, int cpu) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(cpuset), &cpuset) == 0;
+}
+
+int currentCpu() {
+    return sched_getcpu();
+}
+
+int siblingCpu(int cpu) {
+    // Format is a list of CPUs and ranges, e.g. "2,10" or "2-3"
+    std::ifstream file("/sys/devices/system/cpu/cpu" + std::to_string(cpu) +
+                       "/topology/thread_siblings_list");
+    std::string list;
+    if (!std::getline(file, list)) {
+        return -1;
+    }
+    
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t dash = item.find('-');
+        int first = std::stoi(item.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+        for (int candidate = first; candidate <= last; ++candidate) {
+            if (candidate != cpu) {
+                return candidate;
+            }
+        }
+    }
+    return -1;
+}
+
+} // namespace OrderEngine
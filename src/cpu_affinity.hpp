@@ -0,0 +1,17 @@
+#pragma once
+
+#include <thread>
+
+namespace OrderEngine {
+
+// Pins a thread to a single CPU. Returns false if the CPU is invalid or the
+// call is not permitted (the thread keeps running unpinned).
+bool pinThreadToCpu(std::thread& thread, int cpu);
+
+// Returns the CPU currently executing the calling thread, or -1 if unknown
+int currentCpu();
+
+// Returns a hyperthread sibling of cpu from sysfs topology, or -1 if it has none
+int siblingCpu(int cpu);
+
+} // namespace OrderEngine
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace OrderEngine {
+
+// Log-linear latency histogram (HDR style): each power of two is split into
+// 16 linear sub-buckets, giving ~6% relative precision from 1ns to ~18 minutes.
+// Single writer; readers on other threads see relaxed but consistent counts.
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 4;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kMaxExponent = 40;
+    static constexpr int kBucketCount = (kMaxExponent + 1) * kSubBuckets;
+    
+    void record(uint64_t value_ns) {
+        increment(counts_[bucketIndex(value_ns)], 1);
+        increment(total_count_, 1);
+        increment(total_ns_, value_ns);
+        if (value_ns > max_ns_.load(std::memory_order_relaxed)) {
+            max_ns_.store(value_ns, std::memory_order_relaxed);
+        }
+    }
+    
+    // Multi-writer variant: locked increments, for histograms shared between threads
+    void recordConcurrent(uint64_t value_ns) {
+        counts_[bucketIndex(value_ns)].fetch_add(1, std::memory_order_relaxed);
+        total_count_.fetch_add(1, std::memory_order_relaxed);
+        total_ns_.fetch_add(value_ns, std::memory_order_relaxed);
+        uint64_t current_max = max_ns_.load(std::memory_order_relaxed);
+        while (value_ns > current_max &&
+               !max_ns_.compare_exchange_weak(current_max, value_ns, std::memory_order_relaxed));
+    }
+    
+    // Adds another histogram's counts (e.g. per-thread histograms at the end of a run)
+    void merge(const LatencyHistogram& other) {
+        for (int i = 0; i < kBucketCount; ++i) {
+            increment(counts_[i], other.counts_[i].load(std::memory_order_relaxed));
+        }
+        increment(total_count_, other.getCount());
+        increment(total_ns_, other.total_ns_.load(std::memory_order_relaxed));
+        if (other.getMax() > getMax()) {
+            max_ns_.store(other.getMax(), std::memory_order_relaxed);
+        }
+    }
+    
+    void reset() {
+        for (auto& count : counts_) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        total_count_.store(0, std::memory_order_relaxed);
+        total_ns_.store(0, std::memory_order_relaxed);
+        max_ns_.store(0, std::memory_order_relaxed);
+    }
+    
+    uint64_t getCount() const { return total_count_.load(std::memory_order_relaxed); }
+    uint64_t getMax() const { return max_ns_.load(std::memory_order_relaxed); }
+    
+    double getMean() const {
+        uint64_t count = getCount();
+        return count > 0 ? static_cast<double>(total_ns_.load(std::memory_order_relaxed)) / count : 0.0;
+    }
+    
+    // Upper bound of the bucket holding the given percentile (0-100)
+    uint64_t getPercentile(double percentile) const {
+        uint64_t count = getCount();
+        if (count == 0) {
+            return 0;
+        }
+        uint64_t target = static_cast<uint64_t>(percentile / 100.0 * count + 0.5);
+        if (target == 0) {
+            target = 1;
+        }
+        uint64_t seen = 0;
+        for (int i = 0; i < kBucketCount; ++i) {
+            seen += counts_[i].load(std::memory_order_relaxed);
+            if (seen >= target) {
+                uint64_t upper = bucketUpperBound(i);
+                return upper < getMax() ? upper : getMax();
+            }
+        }
+        return getMax();
+    }
+    
+    // Number of recorded values strictly above threshold_ns (bucket resolution)
+    uint64_t getCountAbove(uint64_t threshold_ns) const {
+        uint64_t above = 0;
+        for (int i = bucketIndex(threshold_ns) + 1; i < kBucketCount; ++i) {
+            above += counts_[i].load(std::memory_order_relaxed);
+        }
+        return above;
+    }
+    
+    static int bucketIndex(uint64_t value) {
+        if (value < kSubBuckets) {
+            return static_cast<int>(value);
+        }
+        int exponent = 63 - __builtin_clzll(value);
+        if (exponent > kMaxExponent) {
+            return kBucketCount - 1;
+        }
+        int sub_bucket = static_cast<int>((value >> (exponent - kSubBucketBits)) & (kSubBuckets - 1));
+        return (exponent - kSubBucketBits + 1) * kSubBuckets + sub_bucket;
+    }
+    
+    static uint64_t bucketUpperBound(int index) {
+        if (index < kSubBuckets) {
+            return static_cast<uint64_t>(index);
+        }
+        int exponent = index / kSubBuckets + kSubBucketBits - 1;
+        uint64_t sub_bucket = static_cast<uint64_t>(index % kSubBuckets);
+        uint64_t width = 1ULL << (exponent - kSubBucketBits);
+        return (1ULL << exponent) + (sub_bucket + 1) * width - 1;
+    }
+    
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> counts_{};
+    std::atomic<uint64_t> total_count_{0};
+    std::atomic<uint64_t> total_ns_{0};
+    std::atomic<uint64_t> max_ns_{0};
+    
+    // Single-writer increment: avoids a locked RMW on the recording thread
+    static void increment(std::atomic<uint64_t>& counter, uint64_t delta) {
+        counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+};
+
+} // namespace OrderEngine
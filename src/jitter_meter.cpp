@@ -0,0 +1,39 @@
+#include "jitter_meter.hpp"
+#include "cpu_affinity.hpp"
+#include <chrono>
+
+namespace OrderEngine {
+
+JitterMeter::JitterMeter(int cpu, uint64_t hiccup_threshold_ns)
+    : cpu_(cpu), hiccup_threshold_ns_(hiccup_threshold_ns) {}
+
+JitterMeter::~JitterMeter() {
+    stop();
+}
+
+void JitterMeter::start() {
+    running_ = true;
+    meter_thread_ = std::thread(&JitterMeter::meterThreadFunc, this);
+    if (cpu_ >= 0) {
+        pinned_ = pinThreadToCpu(meter_thread_, cpu_);
+    }
+}
+
+void JitterMeter::stop() {
+    running_ = false;
+    if (meter_thread_.joinable()) {
+        meter_thread_.join();
+    }
+}
+
+void JitterMeter::meterThreadFunc() {
+    auto previous = std::chrono::high_resolution_clock::now();
+    while (running_.load(std::memory_order_relaxed)) {
+        auto now = std::chrono::high_resolution_clock::now();
+        auto gap_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - previous).count();
+        gaps_.record(static_cast<uint64_t>(gap_ns));
+        previous = now;
+    }
+}
+
+} // namespace OrderEngine
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include "histogram.hpp"
+
+namespace OrderEngine {
+
+// Measures platform hiccups (SMIs, preemption, THP compaction) by spinning on
+// a core and recording the gap between consecutive timestamp reads. Gaps seen
+// here are host noise, independent of anything the engine does.
+class JitterMeter {
+public:
+    explicit JitterMeter(int cpu = -1, uint64_t hiccup_threshold_ns = 1000);
+    ~JitterMeter();
+    
+    void start();
+    void stop();
+    
+    int getCpu() const { return cpu_; }
+    bool isPinned() const { return pinned_; }
+    uint64_t getHiccupThresholdNs() const { return hiccup_threshold_ns_; }
+    uint64_t getHiccupCount() const { return gaps_.getCountAbove(hiccup_threshold_ns_); }
+    const LatencyHistogram& getHistogram() const { return gaps_; }
+    
+private:
+    int cpu_;
+    bool pinned_{false};
+    uint64_t hiccup_threshold_ns_;
+    LatencyHistogram gaps_;
+    std::thread meter_thread_;
+    std::atomic<bool> running_{false};
+    
+    void meterThreadFunc();
+};
+
+} // namespace OrderEngine
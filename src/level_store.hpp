@@ -0,0 +1,1021 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "order.hpp"
+#include "occupancy_bitmap.hpp"
+#include "tick_table.hpp"
+
+namespace OrderEngine {
+
+// Resting orders of one side of the book as price levels, best price first.
+// BasicOrderBook drives every store through the same members, with its own
+// Price and Quantity as the first two template parameters:
+//
+//   Config                     constructor argument, shared by both sides
+//   empty()                    no levels on this side
+//   bestPrice() / bestLevel()  the touch and its orders (non-empty only)
+//   popBestLevel()             drop the touch once matching has emptied it
+//   accepts(price)             whether add() could rest an order at price;
+//                              the book refuses orders it cannot rest up front
+//   add(price, id, quantity)   rest an order; false if the store cannot
+//                              represent its price
+//   cancel(price, id)          remove a resting order
+//   appendDepth(out, max)      aggregated levels from the touch outwards
+
+// Orders resting at one price in time order, as parallel id and quantity
+// arrays so a matching policy reads a level's quantities in one pass. Filled
+// orders are popped by advancing head; the arrays are compacted once the dead
+// prefix is both kCompactAfter long and at least half of them.
+template<typename Price, typename Quantity>
+struct LevelQueue {
+    static constexpr size_t kCompactAfter = 32;
+
+    Price price = 0;
+    std::vector<uint64_t> ids;
+    std::vector<Quantity> quantities;
+    size_t head = 0;
+
+    bool empty() const { return head == ids.size(); }
+    size_t count() const { return ids.size() - head; }
+
+    void push(uint64_t id, Quantity quantity) {
+        ids.push_back(id);
+        quantities.push_back(quantity);
+    }
+
+    void popFront() {
+        head++;
+        if (empty()) {
+            clear();
+        } else if (head >= kCompactAfter && head * 2 >= ids.size()) {
+            ids.erase(ids.begin(), ids.begin() + static_cast<std::ptrdiff_t>(head));
+            quantities.erase(quantities.begin(), quantities.begin() + static_cast<std::ptrdiff_t>(head));
+            head = 0;
+        }
+    }
+
+    bool erase(uint64_t id) {
+        for (size_t i = head; i < ids.size(); ++i) {
+            if (ids[i] == id) {
+                ids.erase(ids.begin() + static_cast<std::ptrdiff_t>(i));
+                quantities.erase(quantities.begin() + static_cast<std::ptrdiff_t>(i));
+                if (empty()) {
+                    clear();
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Drops the orders whose quantity has reached zero, keeping time order
+    void compactFilled() {
+        size_t kept = 0;
+        for (size_t i = head; i < ids.size(); ++i) {
+            if (quantities[i] != 0) {
+                ids[kept] = ids[i];
+                quantities[kept] = quantities[i];
+                kept++;
+            }
+        }
+        ids.resize(kept);
+        quantities.resize(kept);
+        head = 0;
+    }
+
+    // Queues other's orders behind these, for two spellings of the same tick
+    void append(const LevelQueue& other) {
+        for (size_t i = other.head; i < other.ids.size(); ++i) {
+            push(other.ids[i], other.quantities[i]);
+        }
+    }
+
+    // Keeps the capacity for the next time this level fills
+    void clear() {
+        ids.clear();
+        quantities.clear();
+        head = 0;
+    }
+
+    PriceLevel summary() const {
+        PriceLevel level{static_cast<double>(price), 0, static_cast<uint32_t>(count())};
+        for (size_t i = head; i < quantities.size(); ++i) {
+            level.quantity += quantities[i];
+        }
+        return level;
+    }
+};
+
+// Level number of price on the tick grid. Integral prices already count
+// ticks, so the table only maps double prices.
+template<typename Price>
+constexpr bool gridLevelOf(const TickTable& ticks, Price price, int64_t& level) {
+    if constexpr (std::is_integral_v<Price>) {
+        level = static_cast<int64_t>(price);
+        return true;
+    } else {
+        return ticks.levelOf(static_cast<double>(price), level);
+    }
+}
+
+// Canonical price of a grid level, which keys it wherever the spellings of
+// one tick must share a level
+template<typename Price>
+Price gridPriceOf(const TickTable& ticks, int64_t level) {
+    if constexpr (std::is_integral_v<Price>) {
+        return static_cast<Price>(level);
+    } else {
+        return static_cast<Price>(ticks.priceOf(level));
+    }
+}
+
+struct TreeConfig {};
+
+// Any price, one red-black tree node per level
+template<typename Price, typename Quantity, OrderSide Side>
+class TreeLevelStore {
+public:
+    using Config = TreeConfig;
+    using Level = LevelQueue<Price, Quantity>;
+
+    explicit TreeLevelStore(const Config& = Config{}) {}
+
+    bool empty() const { return levels_.empty(); }
+    Price bestPrice() const { return levels_.begin()->first; }
+    Level& bestLevel() { return levels_.begin()->second; }
+    void popBestLevel() { levels_.erase(levels_.begin()); }
+    bool accepts(Price) const { return true; }
+
+    bool add(Price price, uint64_t id, Quantity quantity) {
+        Level& level = levels_[price];
+        level.price = price;
+        level.push(id, quantity);
+        return true;
+    }
+
+    bool cancel(Price price, uint64_t id) {
+        auto it = levels_.find(price);
+        if (it == levels_.end() || !it->second.erase(id)) {
+            return false;
+        }
+        if (it->second.empty()) {
+            levels_.erase(it);
+        }
+        return true;
+    }
+
+    void appendDepth(std::vector<PriceLevel>& levels, size_t max_levels) const {
+        for (const auto& entry : levels_) {
+            if (max_levels != 0 && levels.size() == max_levels) {
+                break;
+            }
+            levels.push_back(entry.second.summary());
+        }
+    }
+
+private:
+    using Compare = std::conditional_t<Side == OrderSide::BUY, std::greater<Price>, std::less<Price>>;
+    std::map<Price, Level, Compare> levels_;
+};
+
+struct SortedConfig {};
+
+// Sorted levels for wide or unbounded price ranges, ordered worst to best so
+// the touch is the last level (the finger). The order is split into blocks of
+// at most kBlockLevels levels, each keeping its prices in one array, so
+// creating or removing a level shifts at most one block's entries however
+// deep the book is; a full block splits in two and a block that runs low is
+// merged into a neighbour. A directory holds each block's best price, eight
+// to a cache line, so a search gallops back over the directory from the touch
+// and finishes with a binary search within one block: O(log d) for a level d
+// places away. Popping, matching and adding at the touch only touch the end
+// of the best block. Level queues live in a pool addressed by index, so a
+// shift only moves 4-byte indices; the pool grows as levels are created, so
+// a reference from bestLevel() is only good until the next add.
+//
+// Levels are ordered and found by key, which is their price unless the caller
+// supplies one. The tick stores' overflow tiers key by the tick's canonical
+// price, so every spelling of a tick shares one level, which keeps the price
+// of the order that created it.
+template<typename Price, typename Quantity, OrderSide Side>
+class SortedLevelStore {
+public:
+    using Config = SortedConfig;
+    using Level = LevelQueue<Price, Quantity>;
+
+    static constexpr size_t kBlockLevels = 64;
+
+    explicit SortedLevelStore(const Config& = Config{}) {}
+
+    bool empty() const { return order_.empty(); }
+    Price bestPrice() const { return pool_[bestBlock().queues[bestBlock().count - 1]].price; }
+    Level& bestLevel() { return pool_[bestBlock().queues[bestBlock().count - 1]]; }
+    void popBestLevel() { release({order_.size() - 1, bestBlock().count - 1}); }
+    bool accepts(Price) const { return true; }
+
+    bool add(Price price, uint64_t id, Quantity quantity) { return add(price, price, id, quantity); }
+
+    bool add(Price key, Price price, uint64_t id, Quantity quantity) {
+        Position position = lowerBound(key);
+        if (position.block < order_.size() && priceAt(position) == key) {
+            pool_[queueAt(position)].push(id, quantity);
+            return true;
+        }
+        uint32_t queue = acquire(price);
+        insertAt(position, key, queue);
+        pool_[queue].push(id, quantity);
+        return true;
+    }
+
+    bool cancel(Price key, uint64_t id) {
+        Position position = lowerBound(key);
+        if (position.block == order_.size() || priceAt(position) != key) {
+            return false;
+        }
+        Level& queue = pool_[queueAt(position)];
+        if (!queue.erase(id)) {
+            return false;
+        }
+        if (queue.empty()) {
+            release(position);
+        }
+        return true;
+    }
+
+    void appendDepth(std::vector<PriceLevel>& levels, size_t max_levels) const {
+        for (size_t block = order_.size(); block-- > 0;) {
+            const Block& entries = blocks_[order_[block]];
+            for (size_t slot = entries.count; slot-- > 0;) {
+                if (max_levels != 0 && levels.size() == max_levels) {
+                    return;
+                }
+                levels.push_back(pool_[entries.queues[slot]].summary());
+            }
+        }
+    }
+
+    // Whole-level moves for TieredLevelStore. A pushed level must be better
+    // than every level already here, so both ends are O(1).
+    void pushBestLevel(Price key, Level&& level) {
+        uint32_t queue = acquire(level.price);
+        pool_[queue] = std::move(level);
+        insertAt({order_.size(), 0}, key, queue);
+    }
+
+    Level takeBestLevel() {
+        uint32_t queue = bestBlock().queues[bestBlock().count - 1];
+        Level level = std::move(pool_[queue]);
+        pool_[queue] = Level{};
+        popBestLevel();
+        return level;
+    }
+
+    // Whole-level moves for LadderLevelStore's overflow, at any position. No
+    // level with the same key may already be here.
+    void insertLevel(Price key, Level&& level) {
+        Position position = lowerBound(key);
+        uint32_t queue = acquire(level.price);
+        pool_[queue] = std::move(level);
+        insertAt(position, key, queue);
+    }
+
+    // Removes every level keyed within [low, high], handing each to take best first
+    template<typename Take>
+    void extractLevels(Price low, Price high, Take&& take) {
+        Price better_bound = Side == OrderSide::BUY ? high : low;
+        Price worse_bound = Side == OrderSide::BUY ? low : high;
+        while (!order_.empty()) {
+            // The best level that is not better than the range
+            Position position = lowerBound(better_bound);
+            if (position.block == order_.size() || priceAt(position) != better_bound) {
+                if (position.block == 0 && position.slot == 0) {
+                    return;
+                }
+                position = previous(position);
+            }
+            if (worse(priceAt(position), worse_bound)) {
+                return;
+            }
+            uint32_t queue = queueAt(position);
+            take(std::move(pool_[queue]));
+            pool_[queue] = Level{};
+            release(position);
+        }
+    }
+
+private:
+    struct Block {
+        uint32_t count = 0;
+        Price prices[kBlockLevels];     // Keys, worst to best
+        uint32_t queues[kBlockLevels];  // Pool index of the level at the same slot
+    };
+
+    // Directory index of a block, and slot within it
+    struct Position {
+        size_t block;
+        size_t slot;
+    };
+
+    std::vector<uint32_t> order_;  // Block indices, worst block to best
+    std::vector<Price> fences_;    // Best price of each block in order_
+    std::vector<Block> blocks_;
+    std::vector<uint32_t> free_blocks_;
+    std::vector<Level> pool_;
+    std::vector<uint32_t> free_queues_;
+
+    static bool worse(Price a, Price b) {
+        return Side == OrderSide::BUY ? a < b : a > b;
+    }
+
+    const Block& bestBlock() const { return blocks_[order_.back()]; }
+    Price priceAt(Position position) const { return blocks_[order_[position.block]].prices[position.slot]; }
+    uint32_t queueAt(Position position) const { return blocks_[order_[position.block]].queues[position.slot]; }
+
+    Position previous(Position position) const {
+        if (position.slot > 0) {
+            return {position.block, position.slot - 1};
+        }
+        return {position.block - 1, blocks_[order_[position.block - 1]].count - 1};
+    }
+
+    // First position whose price is not worse than price; {order_.size(), 0}
+    // if every level is worse
+    Position lowerBound(Price price) const {
+        size_t low = 0;
+        size_t high = fences_.size();
+        for (size_t step = 1; high > 0; step *= 2) {
+            size_t probe = high > step ? high - step : 0;
+            if (worse(fences_[probe], price)) {
+                low = probe + 1;
+                break;
+            }
+            high = probe;
+        }
+        size_t block = static_cast<size_t>(
+            std::lower_bound(fences_.begin() + static_cast<std::ptrdiff_t>(low),
+                             fences_.begin() + static_cast<std::ptrdiff_t>(high), price, worse) -
+            fences_.begin());
+        if (block == order_.size()) {
+            return {block, 0};
+        }
+        const Block& entries = blocks_[order_[block]];
+        return {block, static_cast<size_t>(std::lower_bound(entries.prices, entries.prices + entries.count, price, worse) -
+                                           entries.prices)};
+    }
+
+    uint32_t acquire(Price price) {
+        uint32_t queue;
+        if (free_queues_.empty()) {
+            queue = static_cast<uint32_t>(pool_.size());
+            pool_.emplace_back();
+        } else {
+            queue = free_queues_.back();
+            free_queues_.pop_back();
+        }
+        pool_[queue].price = price;
+        return queue;
+    }
+
+    // A new empty block at directory position
+    void addBlock(size_t position) {
+        uint32_t block;
+        if (free_blocks_.empty()) {
+            block = static_cast<uint32_t>(blocks_.size());
+            blocks_.emplace_back();
+        } else {
+            block = free_blocks_.back();
+            free_blocks_.pop_back();
+        }
+        blocks_[block].count = 0;
+        order_.insert(order_.begin() + static_cast<std::ptrdiff_t>(position), block);
+        fences_.insert(fences_.begin() + static_cast<std::ptrdiff_t>(position), Price{});
+    }
+
+    void removeBlock(size_t position) {
+        free_blocks_.push_back(order_[position]);
+        order_.erase(order_.begin() + static_cast<std::ptrdiff_t>(position));
+        fences_.erase(fences_.begin() + static_cast<std::ptrdiff_t>(position));
+    }
+
+    // Appends the entries of the block at position + 1 to the one at position
+    void mergeBlocks(size_t position) {
+        Block& into = blocks_[order_[position]];
+        const Block& from = blocks_[order_[position + 1]];
+        std::copy(from.prices, from.prices + from.count, into.prices + into.count);
+        std::copy(from.queues, from.queues + from.count, into.queues + into.count);
+        into.count += from.count;
+        fences_[position] = fences_[position + 1];
+        removeBlock(position + 1);
+    }
+
+    void insertAt(Position position, Price price, uint32_t queue) {
+        if (order_.empty()) {
+            addBlock(0);
+            position = {0, 0};
+        } else if (position.block == order_.size()) {
+            // Better than every level: the end of the best block
+            position = {order_.size() - 1, blocks_[order_.back()].count};
+        }
+        if (blocks_[order_[position.block]].count == kBlockLevels) {
+            // Split: the better half moves to a new block after this one
+            constexpr size_t half = kBlockLevels / 2;
+            addBlock(position.block + 1);
+            Block& lower = blocks_[order_[position.block]];
+            Block& upper = blocks_[order_[position.block + 1]];
+            std::copy(lower.prices + half, lower.prices + kBlockLevels, upper.prices);
+            std::copy(lower.queues + half, lower.queues + kBlockLevels, upper.queues);
+            lower.count = half;
+            upper.count = kBlockLevels - half;
+            fences_[position.block] = lower.prices[half - 1];
+            fences_[position.block + 1] = upper.prices[upper.count - 1];
+            if (position.slot > half) {
+                position = {position.block + 1, position.slot - half};
+            }
+        }
+        Block& block = blocks_[order_[position.block]];
+        std::copy_backward(block.prices + position.slot, block.prices + block.count, block.prices + block.count + 1);
+        std::copy_backward(block.queues + position.slot, block.queues + block.count, block.queues + block.count + 1);
+        block.prices[position.slot] = price;
+        block.queues[position.slot] = queue;
+        block.count++;
+        fences_[position.block] = block.prices[block.count - 1];
+    }
+
+    // The level must be empty or moved out, as it is once matched out,
+    // cancelled or extracted
+    void release(Position position) {
+        Block& block = blocks_[order_[position.block]];
+        free_queues_.push_back(block.queues[position.slot]);
+        std::copy(block.prices + position.slot + 1, block.prices + block.count, block.prices + position.slot);
+        std::copy(block.queues + position.slot + 1, block.queues + block.count, block.queues + position.slot);
+        block.count--;
+        if (block.count == 0) {
+            removeBlock(position.block);
+            return;
+        }
+        fences_[position.block] = block.prices[block.count - 1];
+        if (block.count < kBlockLevels / 4) {
+            // Merge into a neighbour while the result stays half full at most,
+            // so a level added next to it does not split it straight away
+            size_t block_position = position.block;
+            if (block_position > 0 &&
+                blocks_[order_[block_position - 1]].count + block.count <= kBlockLevels / 2) {
+                mergeBlocks(block_position - 1);
+            } else if (block_position + 1 < order_.size() &&
+                       blocks_[order_[block_position + 1]].count + block.count <= kBlockLevels / 2) {
+                mergeBlocks(block_position);
+            }
+        }
+    }
+};
+
+// Window upkeep of the stores that keep a dense window of tick slots, so the
+// window can be sized per instrument from how often and how far it moves
+struct LevelStoreStats {
+    uint64_t window_moves = 0;     // Times the window was moved
+    uint64_t slots_moved = 0;      // Slots those moves had to touch
+    uint64_t levels_migrated = 0;  // Levels moved into or out of the window
+};
+
+struct LadderConfig {
+    double tick_size = 0.01;
+    TickTable tick_table;   // Banded tick sizes; slots are its levels. Empty: tick_size everywhere
+    size_t levels = 4096;   // Slots in the window
+    // Price of slot 0, in ticks for integral prices; 0 centres the window on
+    // the first order
+    double base_price = 0;
+    // Ticks the window may move per operation to follow the touch (at most a
+    // quarter of the window); 0 keeps it fixed
+    size_t recenter_step = 0;
+};
+
+// Dense price ladder: one slot per tick over a window, with an occupancy
+// bitmap so the next best level is found in a few instructions when the touch
+// empties, however sparse the ladder. Integral prices are tick numbers and
+// index the ladder directly; double prices are mapped through the tick grid,
+// and prices off it cannot rest here. With a fixed window neither can prices
+// outside it. With a tick_table the slots are its levels, so price bands with
+// different tick sizes share one ladder.
+//
+// With recenter_step set the window follows the market instead. The slots
+// form a ring, so moving the base k ticks only touches the k slots that change
+// price: their levels move to an overflow SortedLevelStore and overflow levels
+// at the new prices move in. Once the touch is more than an eighth of the
+// window off centre, every operation moves the base at most recenter_step
+// ticks back towards it, so a trend is followed a few slots at a time rather
+// than with one window-sized shift. Prices outside the window rest in the
+// overflow until the window reaches them, keyed by tick like the slots, so
+// every spelling of a tick lands on one level there too.
+template<typename Price, typename Quantity, OrderSide Side>
+class LadderLevelStore {
+public:
+    using Config = LadderConfig;
+    using Level = LevelQueue<Price, Quantity>;
+
+    explicit LadderLevelStore(const Config& config = Config{})
+        : ticks_(config.tick_table.bands() > 0 ? config.tick_table : TickTable(config.tick_size)),
+          slots_(config.levels), occupied_(config.levels),
+          recenter_step_(static_cast<int64_t>(std::min(config.recenter_step, config.levels / 4))) {
+        if (config.base_price != 0) {
+            int64_t base_ticks = 0;
+            gridLevelOf(ticks_, static_cast<Price>(config.base_price), base_ticks);
+            anchor(base_ticks);
+        }
+    }
+
+    bool empty() const { return best_ == OccupancyBitmap::npos && overflow_.empty(); }
+    Price bestPrice() const { return overflowHasTouch() ? overflow_.bestPrice() : slots_[physical(best_)].price; }
+    Level& bestLevel() { return overflowHasTouch() ? overflow_.bestLevel() : slots_[physical(best_)]; }
+
+    void popBestLevel() {
+        if (overflowHasTouch()) {
+            overflow_.popBestLevel();
+        } else {
+            vacate(best_);
+        }
+        recenter();
+    }
+
+    // On the grid, and inside a fixed window once it is anchored
+    bool accepts(Price price) const {
+        int64_t ticks;
+        return ticksOf(price, ticks) && (recenter_step_ != 0 || !anchored_ || indexOf(ticks) != OccupancyBitmap::npos);
+    }
+
+    bool add(Price price, uint64_t id, Quantity quantity) {
+        int64_t ticks;
+        if (!ticksOf(price, ticks)) {
+            return false;
+        }
+        if (!anchored_) {
+            anchor(ticks - static_cast<int64_t>(slots_.size() / 2));
+        }
+        size_t index = indexOf(ticks);
+        if (index == OccupancyBitmap::npos) {
+            if (recenter_step_ == 0) {
+                return false;
+            }
+            overflow_.add(gridPriceOf<Price>(ticks_, ticks), price, id, quantity);
+            recenter();
+            return true;
+        }
+        Level& slot = slots_[physical(index)];
+        if (slot.empty()) {
+            // Keep the order's own price so the level reports it exactly
+            slot.price = price;
+            occupied_.set(physical(index));
+            if (best_ == OccupancyBitmap::npos || betterIndex(index, best_)) {
+                best_ = index;
+            }
+        }
+        slot.push(id, quantity);
+        recenter();
+        return true;
+    }
+
+    bool cancel(Price price, uint64_t id) {
+        int64_t ticks;
+        if (!ticksOf(price, ticks)) {
+            return false;
+        }
+        size_t index = indexOf(ticks);
+        if (index == OccupancyBitmap::npos) {
+            if (!overflow_.cancel(gridPriceOf<Price>(ticks_, ticks), id)) {
+                return false;
+            }
+        } else {
+            Level& slot = slots_[physical(index)];
+            if (!slot.erase(id)) {
+                return false;
+            }
+            if (slot.empty()) {
+                vacate(index);
+            }
+        }
+        recenter();
+        return true;
+    }
+
+    void appendDepth(std::vector<PriceLevel>& levels, size_t max_levels) const {
+        // Overflow levels are merged in around the window's by price
+        std::vector<PriceLevel> overflow;
+        overflow_.appendDepth(overflow, 0);
+        auto full = [&] { return max_levels != 0 && levels.size() == max_levels; };
+        size_t next = 0;
+        for (size_t index = best_; index != OccupancyBitmap::npos && !full(); index = nextWorse(index)) {
+            PriceLevel slot = slots_[physical(index)].summary();
+            for (; next < overflow.size() && better(overflow[next].price, slot.price) && !full(); ++next) {
+                levels.push_back(overflow[next]);
+            }
+            if (!full()) {
+                levels.push_back(slot);
+            }
+        }
+        for (; next < overflow.size() && !full(); ++next) {
+            levels.push_back(overflow[next]);
+        }
+    }
+
+    LevelStoreStats stats() const { return stats_; }
+
+private:
+    TickTable ticks_;
+    std::vector<Level> slots_;  // Ring: index i (tick base + i) lives in slot physical(i)
+    OccupancyBitmap occupied_;  // By slot
+    int64_t recenter_step_;
+    int64_t base_ticks_{0};
+    size_t head_{0};                      // Slot of index 0
+    bool anchored_{false};
+    size_t best_{OccupancyBitmap::npos};  // Index, not slot
+    SortedLevelStore<Price, Quantity, Side> overflow_;
+    LevelStoreStats stats_;
+
+    void anchor(int64_t base_ticks) {
+        base_ticks_ = base_ticks;
+        anchored_ = true;
+    }
+
+    static constexpr bool betterIndex(size_t a, size_t b) {
+        return Side == OrderSide::BUY ? a > b : a < b;
+    }
+
+    template<typename T>
+    static bool better(T a, T b) {
+        return Side == OrderSide::BUY ? a > b : a < b;
+    }
+
+    // The overflow holds the touch only beyond the window's better edge, or
+    // when the window is empty; never with a fixed window
+    bool overflowHasTouch() const {
+        return !overflow_.empty() &&
+               (best_ == OccupancyBitmap::npos || better(overflow_.bestPrice(), slots_[physical(best_)].price));
+    }
+
+    size_t physical(size_t index) const {
+        size_t slot = index + head_;
+        return slot >= slots_.size() ? slot - slots_.size() : slot;
+    }
+
+    size_t indexOfSlot(size_t slot) const {
+        return slot >= head_ ? slot - head_ : slot + slots_.size() - head_;
+    }
+
+    // Lowest occupied index >= index, or npos
+    size_t nextOccupied(size_t index) const {
+        if (index >= slots_.size()) {
+            return OccupancyBitmap::npos;
+        }
+        size_t slot = physical(index);
+        size_t found = occupied_.findNext(slot);
+        if (slot >= head_) {
+            if (found != OccupancyBitmap::npos) {
+                return indexOfSlot(found);
+            }
+            found = occupied_.findNext(0);  // Wrapped part of the ring
+        }
+        return found < head_ ? indexOfSlot(found) : OccupancyBitmap::npos;
+    }
+
+    // Highest occupied index <= index, or npos
+    size_t prevOccupied(size_t index) const {
+        size_t slot = physical(index);
+        size_t found = occupied_.findPrev(slot);
+        if (slot < head_) {
+            if (found != OccupancyBitmap::npos) {
+                return indexOfSlot(found);
+            }
+            found = occupied_.last();  // Unwrapped part of the ring
+        }
+        return found != OccupancyBitmap::npos && found >= head_ ? indexOfSlot(found) : OccupancyBitmap::npos;
+    }
+
+    size_t nextWorse(size_t index) const {
+        if (Side == OrderSide::BUY) {
+            return index == 0 ? OccupancyBitmap::npos : prevOccupied(index - 1);
+        }
+        return nextOccupied(index + 1);
+    }
+
+    size_t bestIndex() const {
+        return Side == OrderSide::BUY ? prevOccupied(slots_.size() - 1) : nextOccupied(0);
+    }
+
+    void vacate(size_t index) {
+        occupied_.clear(physical(index));
+        if (index == best_) {
+            best_ = nextWorse(index);
+        }
+    }
+
+    // Level number of price on the tick grid (ticks for a single band)
+    bool ticksOf(Price price, int64_t& ticks) const { return gridLevelOf(ticks_, price, ticks); }
+
+    size_t indexOf(int64_t ticks) const {
+        int64_t index = ticks - base_ticks_;
+        if (index < 0 || index >= static_cast<int64_t>(slots_.size())) {
+            return OccupancyBitmap::npos;
+        }
+        return static_cast<size_t>(index);
+    }
+
+    // One bounded step of the base towards centring the touch
+    void recenter() {
+        if (recenter_step_ == 0 || empty()) {
+            return;
+        }
+        int64_t half = static_cast<int64_t>(slots_.size() / 2);
+        int64_t offset;
+        if (overflowHasTouch()) {
+            int64_t ticks;
+            ticksOf(overflow_.bestPrice(), ticks);
+            offset = ticks - base_ticks_ - half;
+        } else {
+            offset = static_cast<int64_t>(best_) - half;
+        }
+        if (std::abs(offset) > static_cast<int64_t>(slots_.size() / 8)) {
+            moveBase(std::clamp(offset, -recenter_step_, recenter_step_));
+        }
+    }
+
+    // Moves the base by shift ticks; the |shift| slots leaving one end of the
+    // window are reused for the ticks entering at the other
+    void moveBase(int64_t shift) {
+        size_t width = slots_.size();
+        size_t count = static_cast<size_t>(std::abs(shift));
+        size_t leaving = shift > 0 ? 0 : width - count;
+        for (size_t index = leaving; index < leaving + count; ++index) {
+            Level& slot = slots_[physical(index)];
+            if (!slot.empty()) {
+                Price key = gridPriceOf<Price>(ticks_, base_ticks_ + static_cast<int64_t>(index));
+                overflow_.insertLevel(key, std::move(slot));
+                slot = Level{};
+                occupied_.clear(physical(index));
+                stats_.levels_migrated++;
+            }
+        }
+        base_ticks_ += shift;
+        head_ = physical(shift > 0 ? count : width - count);
+
+        if (!overflow_.empty()) {
+            int64_t low = base_ticks_ + static_cast<int64_t>(shift > 0 ? width - count : 0);
+            Price low_price = gridPriceOf<Price>(ticks_, low);
+            Price high_price = gridPriceOf<Price>(ticks_, low + static_cast<int64_t>(count) - 1);
+            overflow_.extractLevels(low_price, high_price, [&](Level&& level) {
+                int64_t ticks;
+                ticksOf(level.price, ticks);
+                size_t slot = physical(static_cast<size_t>(ticks - base_ticks_));
+                if (slots_[slot].empty()) {
+                    slots_[slot] = std::move(level);
+                } else {
+                    // Two spellings of the same tick share the slot
+                    slots_[slot].append(level);
+                }
+                occupied_.set(slot);
+                stats_.levels_migrated++;
+            });
+        }
+        best_ = bestIndex();
+        stats_.window_moves++;
+        stats_.slots_moved += count;
+    }
+};
+
+struct TieredConfig {
+    double tick_size = 0.01;
+    TickTable tick_table;  // As for LadderConfig
+    size_t window = 256;  // Dense slots around the touch
+};
+
+// Hot/cold tiers: a small dense window of tick slots that follows the touch,
+// so the levels that see nearly all the activity stay in L1/L2 however big
+// the book gets, and a SortedLevelStore for everything further away. Every
+// cold level is worse than the window, so the touch is always hot.
+//
+// Slots are addressed by offset from the window's better edge (0 = best
+// possible price in the window) and form a ring, as in LadderLevelStore. The
+// touch is kept a quarter of the window in: an order beyond the better edge
+// moves the window out, demoting levels that fall off the far edge a level at
+// a time; when the touch drifts into the far quarter, or the window empties,
+// the window moves in and promotes each cold level whose tick it now covers.
+// A move of k ticks only touches the k slots that change tick, plus the
+// levels it demotes or promotes, so its cost no longer grows with the window.
+// Promotion still happens per move rather than per operation: one move brings
+// in every cold level the market has reached. Prices off the tick grid cannot
+// rest.
+template<typename Price, typename Quantity, OrderSide Side>
+class TieredLevelStore {
+public:
+    using Config = TieredConfig;
+    using Level = LevelQueue<Price, Quantity>;
+
+    explicit TieredLevelStore(const Config& config = Config{})
+        : ticks_(config.tick_table.bands() > 0 ? config.tick_table : TickTable(config.tick_size)),
+          hot_(std::max<size_t>(config.window, 4)), occupied_(hot_.size()),
+          headroom_(static_cast<int64_t>(hot_.size() / 4)) {}
+
+    bool empty() const { return best_ == OccupancyBitmap::npos && cold_.empty(); }
+    // Cold levels are only ever the touch when the window is empty, which
+    // moveWindow() does not leave behind while any remain
+    Price bestPrice() const {
+        return best_ != OccupancyBitmap::npos ? hot_[physical(best_)].price : cold_.bestPrice();
+    }
+    Level& bestLevel() { return best_ != OccupancyBitmap::npos ? hot_[physical(best_)] : cold_.bestLevel(); }
+
+    void popBestLevel() {
+        if (best_ == OccupancyBitmap::npos) {
+            cold_.popBestLevel();
+        } else {
+            vacate(best_);
+        }
+    }
+
+    bool accepts(Price price) const {
+        int64_t ticks;
+        return ticksOf(price, ticks);
+    }
+
+    bool add(Price price, uint64_t id, Quantity quantity) {
+        int64_t ticks;
+        if (!ticksOf(price, ticks)) {
+            return false;
+        }
+        if (!anchored_) {
+            edge_ticks_ = ticks - direction() * headroom_;
+            anchored_ = true;
+        }
+        int64_t offset = offsetOf(ticks);
+        if (offset < 0) {
+            moveWindow(offset - headroom_);
+            offset = headroom_;
+        }
+        if (offset >= static_cast<int64_t>(hot_.size())) {
+            return cold_.add(gridPriceOf<Price>(ticks_, ticks), price, id, quantity);
+        }
+        size_t index = static_cast<size_t>(offset);
+        Level& slot = hot_[physical(index)];
+        if (slot.empty()) {
+            slot.price = price;
+            occupied_.set(physical(index));
+            if (best_ == OccupancyBitmap::npos || index < best_) {
+                best_ = index;
+            }
+        }
+        slot.push(id, quantity);
+        return true;
+    }
+
+    bool cancel(Price price, uint64_t id) {
+        int64_t ticks;
+        if (!ticksOf(price, ticks)) {
+            return false;
+        }
+        int64_t offset = offsetOf(ticks);
+        if (offset < 0 || offset >= static_cast<int64_t>(hot_.size())) {
+            return cold_.cancel(gridPriceOf<Price>(ticks_, ticks), id);
+        }
+        size_t index = static_cast<size_t>(offset);
+        Level& slot = hot_[physical(index)];
+        if (!slot.erase(id)) {
+            return false;
+        }
+        if (slot.empty()) {
+            vacate(index);
+        }
+        return true;
+    }
+
+    void appendDepth(std::vector<PriceLevel>& levels, size_t max_levels) const {
+        for (size_t index = nextOccupied(0); index != OccupancyBitmap::npos; index = nextOccupied(index + 1)) {
+            if (max_levels != 0 && levels.size() == max_levels) {
+                return;
+            }
+            levels.push_back(hot_[physical(index)].summary());
+        }
+        cold_.appendDepth(levels, max_levels);
+    }
+
+    uint64_t windowMoves() const { return window_moves_; }
+    uint64_t promotions() const { return promotions_; }
+    uint64_t demotions() const { return demotions_; }
+    LevelStoreStats stats() const { return {window_moves_, slots_moved_, promotions_ + demotions_}; }
+
+private:
+    TickTable ticks_;
+    std::vector<Level> hot_;    // Ring: offset i (tick edge + i steps) lives in slot physical(i)
+    OccupancyBitmap occupied_;  // By slot
+    int64_t headroom_;
+    int64_t edge_ticks_{0};  // Tick of offset 0
+    size_t head_{0};         // Slot of offset 0
+    bool anchored_{false};
+    size_t best_{OccupancyBitmap::npos};  // Offset, not slot
+    SortedLevelStore<Price, Quantity, Side> cold_;
+    uint64_t window_moves_{0};
+    uint64_t slots_moved_{0};
+    uint64_t promotions_{0};
+    uint64_t demotions_{0};
+
+    // Ticks per offset step: offsets grow towards worse prices
+    static constexpr int64_t direction() { return Side == OrderSide::BUY ? -1 : 1; }
+
+    int64_t offsetOf(int64_t ticks) const { return (ticks - edge_ticks_) * direction(); }
+    int64_t ticksAt(size_t offset) const { return edge_ticks_ + static_cast<int64_t>(offset) * direction(); }
+
+    // Level number of price on the tick grid (ticks for a single band)
+    bool ticksOf(Price price, int64_t& ticks) const { return gridLevelOf(ticks_, price, ticks); }
+
+    size_t physical(size_t offset) const {
+        size_t slot = offset + head_;
+        return slot >= hot_.size() ? slot - hot_.size() : slot;
+    }
+
+    // Lowest occupied offset >= offset, or npos
+    size_t nextOccupied(size_t offset) const {
+        if (offset >= hot_.size()) {
+            return OccupancyBitmap::npos;
+        }
+        size_t slot = physical(offset);
+        size_t found = occupied_.findNext(slot);
+        if (slot >= head_) {
+            if (found != OccupancyBitmap::npos) {
+                return found - head_;
+            }
+            found = occupied_.findNext(0);  // Wrapped part of the ring
+        }
+        return found < head_ ? found + hot_.size() - head_ : OccupancyBitmap::npos;
+    }
+
+    void vacate(size_t offset) {
+        occupied_.clear(physical(offset));
+        if (offset == best_) {
+            best_ = nextOccupied(offset + 1);
+        }
+        size_t far_quarter = hot_.size() - hot_.size() / 4;
+        if (best_ == OccupancyBitmap::npos) {
+            // Window empty: bring the best cold level in at the usual headroom
+            if (!cold_.empty()) {
+                int64_t ticks;
+                ticksOf(cold_.bestPrice(), ticks);
+                moveWindow(offsetOf(ticks) - headroom_);
+            }
+        } else if (best_ >= far_quarter) {
+            moveWindow(static_cast<int64_t>(best_) - headroom_);
+        }
+    }
+
+    // Moves the better edge by shift ticks (positive = towards worse prices);
+    // the slots leaving one end of the window are reused for the ticks
+    // entering at the other
+    void moveWindow(int64_t shift) {
+        if (shift == 0) {
+            return;
+        }
+        window_moves_++;
+        size_t width = hot_.size();
+        size_t count = std::min(static_cast<size_t>(std::abs(shift)), width);
+        if (shift < 0) {
+            // Offsets pushed off the far edge go cold, worst first so each is the cold best
+            for (size_t offset = width; offset-- > width - count;) {
+                Level& slot = hot_[physical(offset)];
+                if (!slot.empty()) {
+                    cold_.pushBestLevel(gridPriceOf<Price>(ticks_, ticksAt(offset)), std::move(slot));
+                    slot = Level{};
+                    occupied_.clear(physical(offset));
+                    demotions_++;
+                }
+            }
+        }
+        // Moving in is only called with every offset before the shift empty
+        head_ = physical(shift > 0 ? count : width - count);
+        edge_ticks_ += shift * direction();
+        slots_moved_ += count;
+
+        // Cold levels whose ticks the window now covers come back, best first
+        while (!cold_.empty()) {
+            int64_t ticks;
+            ticksOf(cold_.bestPrice(), ticks);
+            int64_t offset = offsetOf(ticks);
+            if (offset >= static_cast<int64_t>(width)) {
+                break;
+            }
+            size_t slot = physical(static_cast<size_t>(offset));
+            if (hot_[slot].empty()) {
+                hot_[slot] = cold_.takeBestLevel();
+            } else {
+                // Two spellings of the same tick share the slot
+                hot_[slot].append(cold_.takeBestLevel());
+            }
+            occupied_.set(slot);
+            promotions_++;
+        }
+        best_ = nextOccupied(0);
+    }
+};
+
+} // namespace OrderEngine
@@ -1,4 +1,5 @@
 #include "logger.hpp"
+#include "probe.hpp"
 #include <iomanip>
 #include <sstream>
 
@@ -32,28 +33,63 @@ void TradeLogger::stop() {
 }
 
 void TradeLogger::logTrade(const Trade& trade) {
+    OE_PROBE_SCOPE("logger.enqueue");
     std::lock_guard<std::mutex> lock(queue_mutex_);
-    trade_queue_.push(trade);
+    trade_queue_.push_back(trade);
     queue_cv_.notify_one();
 }
 
+void TradeLogger::logTrades(const TradeBatch& batch) {
+    OE_PROBE_SCOPE("logger.enqueue");
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    trade_queue_.insert(trade_queue_.end(), batch.fills, batch.fills + batch.fill_count);
+    queue_cv_.notify_one();
+}
+
+void TradeLogger::setWrittenCallback(WrittenCallback callback) {
+    written_callback_ = std::move(callback);
+}
+
+size_t TradeLogger::getQueueDepth() {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return trade_queue_.size();
+}
+
 void TradeLogger::loggerThreadFunc() {
-    while (running_ || !trade_queue_.empty()) {
-        std::unique_lock<std::mutex> lock(queue_mutex_);
-        queue_cv_.wait(lock, [this] { return !trade_queue_.empty() || !running_; });
+    // Everything queued is taken in one swap, written and flushed once; the
+    // two vectors trade places so their capacity is reused
+    std::vector<Trade> pending;
+    std::vector<size_t> line_bytes;
+    std::string lines;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this] { return !trade_queue_.empty() || !running_; });
+            if (trade_queue_.empty()) {
+                return;
+            }
+            pending.swap(trade_queue_);
+        }
         
-        while (!trade_queue_.empty()) {
-            Trade trade = trade_queue_.front();
-            trade_queue_.pop();
-            lock.unlock();
-            
-            if (file_.is_open()) {
-                file_ << formatTrade(trade) << "\n";
-                file_.flush();
+        if (file_.is_open()) {
+            OE_PROBE_SCOPE("logger.write");
+            lines.clear();
+            line_bytes.clear();
+            for (const auto& trade : pending) {
+                size_t before = lines.size();
+                lines += formatTrade(trade);
+                lines += '\n';
+                line_bytes.push_back(lines.size() - before);
+            }
+            file_ << lines;
+            file_.flush();
+            if (written_callback_) {
+                for (size_t i = 0; i < pending.size(); ++i) {
+                    written_callback_(pending[i], line_bytes[i]);
+                }
             }
-            
-            lock.lock();
         }
+        pending.clear();
     }
 }
 
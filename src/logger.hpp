@@ -4,9 +4,10 @@
 #include <string>
 #include <mutex>
 #include <thread>
-#include <queue>
+#include <vector>
 #include <condition_variable>
 #include <atomic>
+#include <functional>
 #include "order_book.hpp"
 
 namespace OrderEngine {
@@ -16,17 +17,26 @@ public:
     TradeLogger(const std::string& filename);
     ~TradeLogger();
     
+    // Called on the logging thread for each trade once the pass that wrote it is flushed
+    using WrittenCallback = std::function<void(const Trade&, size_t bytes)>;
+    
     void logTrade(const Trade& trade);
+    // Enqueues every fill of a sweep under one lock and wakes the writer once
+    void logTrades(const TradeBatch& batch);
     void start();
     void stop();
     
+    void setWrittenCallback(WrittenCallback callback);  // Before start()
+    size_t getQueueDepth();
+    
 private:
     std::ofstream file_;
     std::mutex queue_mutex_;
     std::condition_variable queue_cv_;
-    std::queue<Trade> trade_queue_;
+    std::vector<Trade> trade_queue_;  // Swapped out whole by the logging thread
     std::thread logging_thread_;
     std::atomic<bool> running_{false};
+    WrittenCallback written_callback_;
     
     void loggerThreadFunc();
     std::string formatTrade(const Trade& trade);
@@ -15,29 +15,86 @@
 #include "order_book.hpp"
 #include "parser.hpp"
 #include "logger.hpp"
+#include "jitter_meter.hpp"
+#include "cpu_affinity.hpp"
+#include "metrics.hpp"
+#include "probe.hpp"
 
 using namespace OrderEngine;
 
+struct ServerOptions {
+    int port = 8080;
+    uint64_t outlier_threshold_us = 0;  // 0 disables slow-order capture
+    int matcher_cpu = -1;               // -1 leaves the matching thread unpinned
+    bool jitter_meter = false;
+    int jitter_cpu = -1;                // -1 with jitter_meter: matcher's sibling
+    TickTable tick_table;               // No bands: any price is accepted
+};
+
 class OrderBookServer {
 public:
-    OrderBookServer(int port = 8080) : port_(port) {}
+    OrderBookServer(const ServerOptions& options = ServerOptions{})
+        : port_(options.port), outlier_threshold_us_(options.outlier_threshold_us) {
+        order_book_.setMatchingThreadCpu(options.matcher_cpu);
+        if (options.jitter_meter) {
+            int cpu = options.jitter_cpu;
+            if (cpu < 0 && options.matcher_cpu >= 0) {
+                cpu = siblingCpu(options.matcher_cpu);
+            }
+            jitter_meter_ = std::make_unique<JitterMeter>(cpu);
+        }
+        if (options.tick_table.bands() > 0) {
+            parser_.setTickTable(options.tick_table);
+        }
+    }
     
     void start() {
         // Initialize components
-        order_book_.setTradeCallback([this](const Trade& trade) {
-            logger_.logTrade(trade);
-            std::cout << "TRADE: Buy Order " << trade.buy_order_id 
-                      << " matched with Sell Order " << trade.sell_order_id
-                      << " at price " << trade.price 
-                      << " for quantity " << trade.quantity << "\n";
-            total_trades_++;
+        // One batch per aggressive order: logged and printed in a single pass
+        order_book_.setTradeBatchCallback([this](const TradeBatch& batch) {
+            logger_.logTrades(batch);
+            std::ostringstream out;
+            for (size_t i = 0; i < batch.fill_count; ++i) {
+                const Trade& trade = batch.fills[i];
+                out << "TRADE: Buy Order " << trade.buy_order_id
+                    << " matched with Sell Order " << trade.sell_order_id
+                    << " at price " << trade.price
+                    << " for quantity " << trade.quantity << "\n";
+            }
+            if (batch.fill_count > 1) {
+                out << "SWEEP: Order " << batch.aggressor_id << " filled " << batch.filled_quantity
+                    << " over " << batch.levels_swept << " levels, avg price " << batch.averagePrice()
+                    << ", leaves " << batch.leaves_quantity << "\n";
+            }
+            std::cout << out.str();
+            total_trades_ += batch.fill_count;
         });
         
+        if (outlier_threshold_us_ > 0) {
+            order_book_.setLatencyOutlierThreshold(outlier_threshold_us_ * 1000);
+            order_book_.setOutlierCallback([](const LatencyOutlier& outlier) {
+                std::cout << "SLOW ORDER: id " << outlier.order_id
+                          << " side " << (outlier.side == OrderSide::BUY ? "buy" : "sell")
+                          << " price " << outlier.price
+                          << " latency " << outlier.latency_ns / 1000.0 << "µs"
+                          << " levels " << outlier.levels_swept
+                          << " orders " << outlier.orders_swept
+                          << " queue_depth " << outlier.queue_depth
+                          << " invol_csw " << outlier.involuntary_ctx_switches << "\n";
+            });
+        }
+        
         logger_.start();
         order_book_.start();
+        if (jitter_meter_) {
+            jitter_meter_->start();
+        }
         
         std::cout << "Ultra-Low Latency Order Book Engine Starting...\n";
         std::cout << "Server listening on port " << port_ << "\n";
+        if (outlier_threshold_us_ > 0) {
+            std::cout << "Logging orders slower than " << outlier_threshold_us_ << "µs\n";
+        }
         
         // Start threads
         std::thread console_thread(&OrderBookServer::consoleInputThread, this);
@@ -52,6 +109,9 @@ public:
         if (stats_thread.joinable()) stats_thread.join();
         if (tcp_thread.joinable()) tcp_thread.join();
         
+        if (jitter_meter_) {
+            jitter_meter_->stop();
+        }
         order_book_.stop();
         logger_.stop();
     }
@@ -60,13 +120,16 @@ private:
     OrderBook order_book_;
     OrderParser parser_;
     TradeLogger logger_{"trades.csv"};
+    std::unique_ptr<JitterMeter> jitter_meter_;
     int port_;
+    uint64_t outlier_threshold_us_;
     std::atomic<bool> running_{true};
     std::atomic<uint64_t> total_trades_{0};
     
     void consoleInputThread() {
         std::cout << "Commands: 'quit', 'stats', or JSON orders\n";
-        std::cout << "Example: {\"side\":\"buy\",\"price\":100.50,\"quantity\":10}\n\n";
+        std::cout << "Example: {\"side\":\"buy\",\"price\":100.50,\"quantity\":10}\n";
+        std::cout << "Cancel:  {\"type\":\"cancel\",\"id\":1}\n\n";
         
         std::string input;
         while (std::getline(std::cin, input) && running_) {
@@ -81,10 +144,12 @@ private:
     }
     
     void processOrderString(const std::string& order_str) {
+        OE_PROBE_SCOPE("server.console_order");
         auto start_time = std::chrono::high_resolution_clock::now();
         
-        auto order = parser_.parseOrder(order_str);
-        if (order) {
+        if (auto cancel_id = parser_.parseCancel(order_str)) {
+            order_book_.submitCancel(*cancel_id);
+        } else if (auto order = parser_.parseOrder(order_str)) {
             order_book_.submitOrder(std::move(*order));
         } else {
             std::cout << "Error: Invalid order format\n";
@@ -117,8 +182,23 @@ private:
                   << stats.getAverageLatencyUs() << "µs\n";
         std::cout << "Min Latency: " << stats.getMinLatencyUs() << "µs\n";
         std::cout << "Max Latency: " << stats.getMaxLatencyUs() << "µs\n";
+        if (jitter_meter_) {
+            // Host noise seen by an idle spinning thread, for comparison with the above
+            const auto& gaps = jitter_meter_->getHistogram();
+            std::cout << "Platform Jitter (cpu " << jitter_meter_->getCpu()
+                      << (jitter_meter_->isPinned() ? "" : ", unpinned") << "): "
+                      << "p99 " << gaps.getPercentile(99.0) / 1000.0 << "µs | "
+                      << "p99.99 " << gaps.getPercentile(99.99) / 1000.0 << "µs | "
+                      << "max " << gaps.getMax() / 1000.0 << "µs | "
+                      << "hiccups >" << jitter_meter_->getHiccupThresholdNs() / 1000.0 << "µs: "
+                      << jitter_meter_->getHiccupCount() << "\n";
+        }
         std::cout << "Active Buy Orders: " << order_book_.getBuyOrdersCount() << "\n";
         std::cout << "Active Sell Orders: " << order_book_.getSellOrdersCount() << "\n";
+        if constexpr (kProbesEnabled) {
+            std::cout << "--- Probes ---\n";
+            MetricsRegistry::instance().report(std::cout);
+        }
         std::cout << "============================\n\n";
     }
     
@@ -169,40 +249,97 @@ private:
     }
     
     void handleClient(int client_fd) {
-        char buffer[1024];
+        char buffer[4096];
+        std::string pending;  // Partial line carried over between reads
         while (running_) {
-            int bytes_read = read(client_fd, buffer, sizeof(buffer) - 1);
+            int bytes_read = read(client_fd, buffer, sizeof(buffer));
             if (bytes_read <= 0) break;
             
-            buffer[bytes_read] = '\0';
-            std::string order_str(buffer);
-            
-            std::istringstream iss(order_str);
-            std::string line;
-            while (std::getline(iss, line)) {
+            pending.append(buffer, bytes_read);
+            std::string responses;
+            size_t line_start = 0;
+            size_t newline;
+            while ((newline = pending.find('\n', line_start)) != std::string::npos) {
+                std::string line = pending.substr(line_start, newline - line_start);
+                line_start = newline + 1;
+                if (!line.empty() && line.back() == '\r') {
+                    line.pop_back();
+                }
                 if (!line.empty()) {
+                    OE_PROBE_SCOPE("server.tcp_order");
+                    // Acks carry the order id so pipelined clients can match them to requests
+                    if (auto cancel_id = parser_.parseCancel(line)) {
+                        order_book_.submitCancel(*cancel_id);
+                        responses += "ACK: Cancel received id=" + std::to_string(*cancel_id) + "\n";
+                        continue;
+                    }
                     auto order = parser_.parseOrder(line);
                     if (order) {
+                        uint64_t order_id = (*order)->id;
                         order_book_.submitOrder(std::move(*order));
-                        
-                        std::string response = "ACK: Order received\n";
-                        write(client_fd, response.c_str(), response.length());
+                        responses += "ACK: Order received id=" + std::to_string(order_id) + "\n";
                     }
                 }
             }
+            pending.erase(0, line_start);
+            
+            if (!writeAll(client_fd, responses)) break;
         }
         close(client_fd);
     }
+    
+    static bool writeAll(int fd, const std::string& data) {
+        size_t written = 0;
+        while (written < data.size()) {
+            ssize_t n = write(fd, data.data() + written, data.size() - written);
+            if (n <= 0) return false;
+            written += static_cast<size_t>(n);
+        }
+        return true;
+    }
 };
 
 int main(int argc, char* argv[]) {
-    int port = 8080;
-    if (argc > 1) {
-        port = std::atoi(argv[1]);
-    }
-    
+    // Usage: order_engine [port] [--outlier-us=N] [--matcher-cpu=N] [--jitter-cpu=N|sibling]
+    //                     [--ticks=FROM:TICK,...]   e.g. --ticks=0:0.01,1:0.05,10:0.1
     try {
-        OrderBookServer server(port);
+        ServerOptions options;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.rfind("--outlier-us=", 0) == 0) {
+                options.outlier_threshold_us = std::stoull(arg.substr(13));
+            } else if (arg.rfind("--matcher-cpu=", 0) == 0) {
+                options.matcher_cpu = std::stoi(arg.substr(14));
+            } else if (arg.rfind("--jitter-cpu=", 0) == 0) {
+                std::string value = arg.substr(13);
+                options.jitter_meter = true;
+                options.jitter_cpu = value == "sibling" ? -1 : std::stoi(value);
+            } else if (arg.rfind("--ticks=", 0) == 0) {
+                std::stringstream bands(arg.substr(8));
+                std::string band;
+                while (std::getline(bands, band, ',')) {
+                    size_t colon = band.find(':');
+                    if (colon == std::string::npos) {
+                        throw std::invalid_argument("--ticks bands are FROM:TICK");
+                    }
+                    options.tick_table.add({std::stod(band.substr(0, colon)), std::stod(band.substr(colon + 1))});
+                }
+            } else {
+                options.port = std::atoi(argv[i]);
+            }
+        }
+        if (options.jitter_meter && options.jitter_cpu < 0) {
+            // An unpinned meter shares no core with the matcher, so it would measure nothing useful
+            if (options.matcher_cpu < 0) {
+                throw std::invalid_argument("--jitter-cpu=sibling requires --matcher-cpu");
+            }
+            if (siblingCpu(options.matcher_cpu) < 0) {
+                throw std::invalid_argument("--jitter-cpu=sibling: cpu " + std::to_string(options.matcher_cpu) +
+                                            " has no hyperthread sibling; give --jitter-cpu=N");
+            }
+        }
+        
+        OrderBookServer server(options);
         server.start();
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
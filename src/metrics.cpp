@@ -0,0 +1,57 @@
+#include "metrics.hpp"
+#include <iomanip>
+
+namespace OrderEngine {
+
+MetricsRegistry& MetricsRegistry::instance() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+LatencyHistogram& MetricsRegistry::histogram(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = histograms_[name];
+    if (!slot) {
+        slot = std::make_unique<LatencyHistogram>();
+    }
+    return *slot;
+}
+
+std::atomic<uint64_t>& MetricsRegistry::counter(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = counters_[name];
+    if (!slot) {
+        slot = std::make_unique<std::atomic<uint64_t>>(0);
+    }
+    return *slot;
+}
+
+void MetricsRegistry::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : histograms_) {
+        entry.second->reset();
+    }
+    for (auto& entry : counters_) {
+        entry.second->store(0, std::memory_order_relaxed);
+    }
+}
+
+void MetricsRegistry::report(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    out << std::fixed << std::setprecision(2);
+    for (const auto& entry : histograms_) {
+        const auto& h = *entry.second;
+        out << std::left << std::setw(24) << entry.first << std::right
+            << " count " << h.getCount()
+            << " | mean " << h.getMean() / 1000.0 << "µs"
+            << " | p50 " << h.getPercentile(50.0) / 1000.0 << "µs"
+            << " | p99 " << h.getPercentile(99.0) / 1000.0 << "µs"
+            << " | max " << h.getMax() / 1000.0 << "µs\n";
+    }
+    for (const auto& entry : counters_) {
+        out << std::left << std::setw(24) << entry.first << std::right
+            << " " << entry.second->load(std::memory_order_relaxed) << "\n";
+    }
+}
+
+} // namespace OrderEngine
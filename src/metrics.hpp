@@ -0,0 +1,35 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include "histogram.hpp"
+
+namespace OrderEngine {
+
+// Process-wide named latency histograms and counters. Lookup takes a lock and
+// is meant to happen once per call site (see probe.hpp); the returned
+// references stay valid for the life of the process.
+class MetricsRegistry {
+public:
+    static MetricsRegistry& instance();
+    
+    LatencyHistogram& histogram(const std::string& name);
+    std::atomic<uint64_t>& counter(const std::string& name);
+    
+    // Clears all values, keeping registrations (and call-site references) intact
+    void reset();
+    void report(std::ostream& out) const;
+    
+private:
+    MetricsRegistry() = default;
+    
+    mutable std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<LatencyHistogram>> histograms_;
+    std::map<std::string, std::unique_ptr<std::atomic<uint64_t>>> counters_;
+};
+
+} // namespace OrderEngine
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace OrderEngine {
+
+// Hierarchical occupancy bitmap over a dense array of slots. Layer 0 has one
+// bit per slot; each higher layer has one bit per non-zero word of the layer
+// below, up to a single top word. Finding the next or previous occupied slot
+// is one count-zeros per layer (tzcnt/lzcnt with -march=native), however
+// wide the gap: three layers cover 262144 slots.
+class OccupancyBitmap {
+public:
+    static constexpr size_t npos = SIZE_MAX;
+
+    explicit OccupancyBitmap(size_t slots = 0) : slots_(slots) {
+        size_t words = (slots + 63) / 64;
+        do {
+            words = words > 0 ? words : 1;
+            layers_.emplace_back(words, 0);
+            words = (words + 63) / 64;
+        } while (layers_.back().size() > 1);
+    }
+
+    size_t size() const { return slots_; }
+
+    bool test(size_t slot) const {
+        return (layers_[0][slot >> 6] >> (slot & 63)) & 1;
+    }
+
+    void set(size_t slot) {
+        for (auto& layer : layers_) {
+            uint64_t& word = layer[slot >> 6];
+            bool was_empty = word == 0;
+            word |= uint64_t{1} << (slot & 63);
+            if (!was_empty) {
+                return;  // Layers above already see this word as occupied
+            }
+            slot >>= 6;
+        }
+    }
+
+    void clear(size_t slot) {
+        for (auto& layer : layers_) {
+            uint64_t& word = layer[slot >> 6];
+            word &= ~(uint64_t{1} << (slot & 63));
+            if (word != 0) {
+                return;
+            }
+            slot >>= 6;
+        }
+    }
+
+    // Lowest occupied slot >= slot, or npos
+    size_t findNext(size_t slot) const {
+        if (slot >= slots_) {
+            return npos;
+        }
+        size_t layer = 0;
+        while (true) {
+            size_t word = slot >> 6;
+            uint64_t bits = layers_[layer][word] & (~uint64_t{0} << (slot & 63));
+            if (bits != 0) {
+                slot = (word << 6) | static_cast<size_t>(__builtin_ctzll(bits));
+                break;
+            }
+            // Nothing left in this word: continue after it one layer up
+            if (++layer == layers_.size() || word + 1 >= layers_[layer - 1].size()) {
+                return npos;
+            }
+            slot = word + 1;
+        }
+        while (layer > 0) {
+            --layer;
+            slot = (slot << 6) | static_cast<size_t>(__builtin_ctzll(layers_[layer][slot]));
+        }
+        return slot;
+    }
+
+    // Highest occupied slot <= slot, or npos
+    size_t findPrev(size_t slot) const {
+        if (slots_ == 0) {
+            return npos;
+        }
+        if (slot >= slots_) {
+            slot = slots_ - 1;
+        }
+        size_t layer = 0;
+        while (true) {
+            size_t word = slot >> 6;
+            size_t bit = slot & 63;
+            uint64_t mask = bit == 63 ? ~uint64_t{0} : (uint64_t{1} << (bit + 1)) - 1;
+            uint64_t bits = layers_[layer][word] & mask;
+            if (bits != 0) {
+                slot = (word << 6) | static_cast<size_t>(63 - __builtin_clzll(bits));
+                break;
+            }
+            if (++layer == layers_.size() || word == 0) {
+                return npos;
+            }
+            slot = word - 1;
+        }
+        while (layer > 0) {
+            --layer;
+            slot = (slot << 6) | static_cast<size_t>(63 - __builtin_clzll(layers_[layer][slot]));
+        }
+        return slot;
+    }
+
+    size_t first() const { return findNext(0); }
+    size_t last() const { return findPrev(slots_); }
+
+private:
+    size_t slots_;
+    std::vector<std::vector<uint64_t>> layers_;
+};
+
+} // namespace OrderEngine
@@ -1,10 +1,52 @@
 #include "order_book.hpp"
+#include "cpu_affinity.hpp"
+#include "probe.hpp"
 #include <algorithm>
 #include <iostream>
+#include <sys/resource.h>
 
 namespace OrderEngine {
 
-OrderBook::OrderBook() = default;
+namespace {
+constexpr size_t kInitialFillCapacity = 64;  // Levels a typical sweep stays within
+
+// Stores without a window have no upkeep to report
+template<typename Store>
+auto windowStats(const Store& store, int) -> decltype(store.stats()) {
+    return store.stats();
+}
+
+template<typename Store>
+LevelStoreStats windowStats(const Store&, long) {
+    return {};
+}
+}
+
+OrderBook::OrderBook(const OrderBookConfig& config) {
+    if (config.level_store == LevelStoreType::LADDER) {
+        emplaceBook<LadderLevelStore>(config.ladder, config.matching);
+    } else if (config.level_store == LevelStoreType::SORTED) {
+        emplaceBook<SortedLevelStore>(SortedConfig{}, config.matching);
+    } else if (config.level_store == LevelStoreType::TIERED) {
+        emplaceBook<TieredLevelStore>(config.tiered, config.matching);
+    } else {
+        emplaceBook<TreeLevelStore>(TreeConfig{}, config.matching);
+    }
+    fills_.reserve(kInitialFillCapacity);
+}
+
+template<template<typename, typename, OrderSide> class Levels>
+void OrderBook::emplaceBook(const typename Levels<double, uint32_t, OrderSide::BUY>::Config& levels,
+                            MatchingPolicy matching) {
+    FillCollector collector{&fills_};
+    if (matching == MatchingPolicy::PRO_RATA) {
+        book_.emplace<ProRata<Levels>>(levels, collector);
+    } else if (matching == MatchingPolicy::PRO_RATA_TOP) {
+        book_.emplace<ProRataTop<Levels>>(levels, collector);
+    } else {
+        book_.emplace<PriceTime<Levels>>(levels, collector);
+    }
+}
 OrderBook::~OrderBook() {
     stop();
 }
@@ -12,6 +54,9 @@ OrderBook::~OrderBook() {
 void OrderBook::start() {
     running_ = true;
     matching_thread_ = std::thread(&OrderBook::matchingThreadFunc, this);
+    if (matching_cpu_ >= 0 && !pinThreadToCpu(matching_thread_, matching_cpu_)) {
+        std::cerr << "Failed to pin matching thread to CPU " << matching_cpu_ << "\n";
+    }
 }
 
 void OrderBook::stop() {
@@ -23,96 +68,175 @@ void OrderBook::stop() {
 }
 
 void OrderBook::submitOrder(std::unique_ptr<Order> order) {
+    OE_PROBE_SCOPE("order_book.submit");
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    order_queue_.push(OrderRequest{std::move(order), 0});
+    queue_cv_.notify_one();
+}
+
+void OrderBook::submitCancel(uint64_t order_id) {
     std::lock_guard<std::mutex> lock(queue_mutex_);
-    order_queue_.push(std::move(order));
+    order_queue_.push(OrderRequest{nullptr, order_id});
     queue_cv_.notify_one();
 }
 
+void OrderBook::processOrderSync(std::unique_ptr<Order> order) {
+    processOrder(std::move(order), 0);
+}
+
 void OrderBook::setTradeCallback(TradeCallback callback) {
     trade_callback_ = std::move(callback);
 }
 
+void OrderBook::setTradeBatchCallback(TradeBatchCallback callback) {
+    trade_batch_callback_ = std::move(callback);
+}
+
+void OrderBook::setLatencyOutlierThreshold(uint64_t threshold_ns) {
+    outlier_threshold_ns_ = threshold_ns;
+}
+
+void OrderBook::setOutlierCallback(OutlierCallback callback) {
+    outlier_callback_ = std::move(callback);
+}
+
+static long threadInvoluntaryContextSwitches() {
+    rusage usage{};
+    if (getrusage(RUSAGE_THREAD, &usage) != 0) {
+        return 0;
+    }
+    return usage.ru_nivcsw;
+}
+
 void OrderBook::matchingThreadFunc() {
     while (running_ || !order_queue_.empty()) {
         std::unique_lock<std::mutex> lock(queue_mutex_);
         queue_cv_.wait(lock, [this] { return !order_queue_.empty() || !running_; });
         
         while (!order_queue_.empty()) {
-            auto order = std::move(order_queue_.front());
+            auto request = std::move(order_queue_.front());
             order_queue_.pop();
+            size_t queue_depth = order_queue_.size();
             lock.unlock();
             
-            processOrder(std::move(order));
+            if (request.order) {
+                processOrder(std::move(request.order), queue_depth);
+            } else {
+                cancelOrderSync(request.cancel_id);
+            }
             
             lock.lock();
         }
     }
 }
 
-void OrderBook::processOrder(std::unique_ptr<Order> order) {
+void OrderBook::processOrder(std::unique_ptr<Order> order, size_t queue_depth) {
+    OE_PROBE_SCOPE("order_book.process");
     auto start_time = std::chrono::high_resolution_clock::now();
     
-    if (order->side == OrderSide::BUY) {
-        buy_orders_.emplace(order->price, std::move(order));
-    } else {
-        sell_orders_.emplace(order->price, std::move(order));
+    // Sampled only when outlier capture is enabled; it costs a syscall
+    const bool capture_outliers = outlier_threshold_ns_ > 0 && outlier_callback_;
+    long start_ctx_switches = capture_outliers ? threadInvoluntaryContextSwitches() : 0;
+    SweepStats sweep = std::visit([&order](auto& book) {
+        OE_PROBE_SCOPE("order_book.match");
+        book.submit(order->id, order->side, order->price, order->quantity);
+        return book.lastSweep();
+    }, book_);
+    if (!fills_.empty()) {
+        publishFills(*order, sweep);
     }
     
-    matchOrders();
-    
     auto end_time = std::chrono::high_resolution_clock::now();
     auto latency_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
         end_time - start_time).count();
     
     latency_stats_.recordLatency(latency_ns);
+    
+    if (capture_outliers && static_cast<uint64_t>(latency_ns) > outlier_threshold_ns_) {
+        LatencyOutlier outlier{
+            order->id,
+            order->side,
+            order->price,
+            static_cast<uint64_t>(latency_ns),
+            sweep.levels,
+            sweep.orders,
+            queue_depth,
+            threadInvoluntaryContextSwitches() - start_ctx_switches
+        };
+        outlier_callback_(outlier);
+    }
 }
 
-void OrderBook::matchOrders() {
-    while (!buy_orders_.empty() && !sell_orders_.empty()) {
-        auto buy_it = buy_orders_.begin();  // Highest price
-        auto sell_it = sell_orders_.begin();  // Lowest price
-        
-        if (buy_it->first < sell_it->first) {
-            break;  // No match possible
-        }
-        
-        auto& buy_order = *buy_it->second;
-        auto& sell_order = *sell_it->second;
-        
-        uint32_t trade_quantity = std::min(buy_order.quantity, sell_order.quantity);
-        executeTrade(buy_order, sell_order, trade_quantity);
-        
-        buy_order.quantity -= trade_quantity;
-        sell_order.quantity -= trade_quantity;
-        
-        if (buy_order.quantity == 0) {
-            buy_orders_.erase(buy_it);
-        }
-        if (sell_order.quantity == 0) {
-            sell_orders_.erase(sell_it);
-        }
-    }
+bool OrderBook::cancelOrderSync(uint64_t order_id) {
+    OE_PROBE_SCOPE("order_book.cancel");
+    return std::visit([order_id](auto& book) { return book.cancel(order_id); }, book_);
 }
 
-void OrderBook::executeTrade(Order& buy_order, Order& sell_order, uint32_t quantity) {
-    if (trade_callback_) {
-        Trade trade{
-            buy_order.id,
-            sell_order.id,
-            sell_order.price,  // Trade at sell order price (price-time priority)
-            quantity,
-            std::chrono::high_resolution_clock::now()
+void OrderBook::publishFills(const Order& incoming, const SweepStats& sweep) {
+    OE_PROBE_COUNT("order_book.trades", fills_.size());
+    auto timestamp = std::chrono::high_resolution_clock::now();
+    uint32_t filled = 0;
+    double notional = 0.0;
+    for (auto& fill : fills_) {
+        fill.timestamp = timestamp;
+        filled += fill.quantity;
+        notional += fill.price * fill.quantity;
+    }
+    
+    if (trade_batch_callback_) {
+        TradeBatch batch{
+            incoming.id,
+            incoming.side,
+            incoming.price,
+            filled,
+            incoming.quantity - filled,
+            sweep.levels,
+            notional,
+            timestamp,
+            fills_.data(),
+            fills_.size()
         };
-        trade_callback_(trade);
+        trade_batch_callback_(batch);
+    }
+    if (trade_callback_) {
+        for (const auto& fill : fills_) {
+            trade_callback_(fill);
+        }
     }
+    fills_.clear();
 }
 
 size_t OrderBook::getBuyOrdersCount() const {
-    return buy_orders_.size();
+    return std::visit([](const auto& book) { return book.orderCount(OrderSide::BUY); }, book_);
 }
 
 size_t OrderBook::getSellOrdersCount() const {
-    return sell_orders_.size();
+    return std::visit([](const auto& book) { return book.orderCount(OrderSide::SELL); }, book_);
+}
+
+std::optional<double> OrderBook::getBestBid() const {
+    return std::visit([](const auto& book) { return book.bestBid(); }, book_);
+}
+
+std::optional<double> OrderBook::getBestAsk() const {
+    return std::visit([](const auto& book) { return book.bestAsk(); }, book_);
+}
+
+std::vector<PriceLevel> OrderBook::getDepth(OrderSide side, size_t max_levels) const {
+    return std::visit([&](const auto& book) { return book.depth(side, max_levels); }, book_);
+}
+
+uint64_t OrderBook::getRejectedCount() const {
+    return std::visit([](const auto& book) { return book.rejectedCount(); }, book_);
+}
+
+LevelStoreStats OrderBook::getLevelStoreStats() const {
+    return std::visit([](const auto& book) {
+        LevelStoreStats buy = windowStats(book.buyLevels(), 0);
+        LevelStoreStats sell = windowStats(book.sellLevels(), 0);
+        return LevelStoreStats{buy.window_moves + sell.window_moves, buy.slots_moved + sell.slots_moved,
+                               buy.levels_migrated + sell.levels_migrated};
+    }, book_);
 }
 
 } // namespace OrderEngine
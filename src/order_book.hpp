@@ -1,6 +1,5 @@
 #pragma once
 
-#include <map>
 #include <memory>
 #include <atomic>
 #include <chrono>
@@ -9,34 +8,30 @@
 #include <mutex>
 #include <condition_variable>
 #include <thread>
-#include "memory_pool.hpp"
+#include <optional>
+#include <variant>
+#include <vector>
+#include "order.hpp"
+#include "basic_order_book.hpp"
 
 namespace OrderEngine {
 
-enum class OrderSide { BUY, SELL };
-
-struct Order {
-    uint64_t id;
-    OrderSide side;
-    double price;
-    uint32_t quantity;
+// Everything one incoming order traded, reported once after its sweep. The
+// fills share one timestamp and live in the book's reusable fill array, so
+// they are only valid for the duration of the callback.
+struct TradeBatch {
+    uint64_t aggressor_id;
+    OrderSide aggressor_side;
+    double limit_price;
+    uint32_t filled_quantity;
+    uint32_t leaves_quantity;  // Left to rest on the book, 0 if fully filled
+    uint32_t levels_swept;
+    double notional;           // Sum of price * quantity over the fills
     std::chrono::high_resolution_clock::time_point timestamp;
+    const Trade* fills;        // One per resting counterparty, in match order
+    size_t fill_count;
     
-    // Default constructor for memory pool
-    Order() : id(0), side(OrderSide::BUY), price(0.0), quantity(0), 
-              timestamp(std::chrono::high_resolution_clock::now()) {}
-    
-    Order(uint64_t id, OrderSide side, double price, uint32_t quantity)
-        : id(id), side(side), price(price), quantity(quantity), 
-          timestamp(std::chrono::high_resolution_clock::now()) {}
-};
-
-struct Trade {
-    uint64_t buy_order_id;
-    uint64_t sell_order_id;
-    double price;
-    uint32_t quantity;
-    std::chrono::high_resolution_clock::time_point timestamp;
+    double averagePrice() const { return filled_quantity > 0 ? notional / filled_quantity : 0.0; }
 };
 
 struct LatencyStats {
@@ -73,46 +68,148 @@ struct LatencyStats {
     }
 };
 
+// Context captured for an order whose processing exceeded the outlier threshold
+struct LatencyOutlier {
+    uint64_t order_id;
+    OrderSide side;
+    double price;
+    uint64_t latency_ns;
+    uint32_t levels_swept;          // Distinct opposite-side price levels traded against
+    uint32_t orders_swept;          // Resting orders traded against
+    size_t queue_depth;             // Orders still queued when this one was dequeued
+    long involuntary_ctx_switches;  // Matching thread preemptions while processing
+};
+
+// How resting orders are stored (src/level_store.hpp)
+enum class LevelStoreType {
+    TREE,    // std::map of levels per side: any price, O(log n) everywhere
+    LADDER,  // Dense tick ladder with an occupancy bitmap: fixed window, O(1) at the touch
+    SORTED,  // Sorted blocks of levels searched from the touch: any price, cache-friendly
+    TIERED,  // Dense window following the touch, sorted array for far levels
+};
+
+// How an incoming order is shared out among the orders resting at one price
+// (the matching policies in src/basic_order_book.hpp)
+enum class MatchingPolicy {
+    PRICE_TIME,    // FifoMatching: earliest order first
+    PRO_RATA,      // ProRataMatching<>: in proportion to size
+    PRO_RATA_TOP,  // ProRataMatching<true>: earliest order first, the rest in proportion to size
+};
+
+struct OrderBookConfig {
+    LevelStoreType level_store = LevelStoreType::TREE;
+    MatchingPolicy matching = MatchingPolicy::PRICE_TIME;
+    LadderConfig ladder;  // Used by LADDER
+    TieredConfig tiered;  // Used by TIERED
+};
+
 class OrderBook {
 public:
     using TradeCallback = std::function<void(const Trade&)>;
+    using TradeBatchCallback = std::function<void(const TradeBatch&)>;
+    using OutlierCallback = std::function<void(const LatencyOutlier&)>;
     
-    OrderBook();
+    explicit OrderBook(const OrderBookConfig& config = OrderBookConfig{});
     ~OrderBook();
     
     void start();
     void stop();
     void submitOrder(std::unique_ptr<Order> order);
+    void submitCancel(uint64_t order_id);
+    
+    // Runs the matching path on the calling thread, bypassing the queue.
+    // For benchmarks and replay; only valid while the matching thread is stopped.
+    void processOrderSync(std::unique_ptr<Order> order);
+    // Removes a resting order; returns false if it is unknown or already filled
+    bool cancelOrderSync(uint64_t order_id);
+    // Per-fill callback; runs after the batch callback once the sweep is done
     void setTradeCallback(TradeCallback callback);
+    void setTradeBatchCallback(TradeBatchCallback callback);
+    
+    // Orders slower than threshold_ns are reported to the outlier callback (0 disables).
+    // Set before start(); enabling costs one getrusage() call per order.
+    void setLatencyOutlierThreshold(uint64_t threshold_ns);
+    void setOutlierCallback(OutlierCallback callback);
+    
+    // Pins the matching thread when start() is called (-1 leaves it unpinned)
+    void setMatchingThreadCpu(int cpu) { matching_cpu_ = cpu; }
+    int getMatchingThreadCpu() const { return matching_cpu_; }
     
     size_t getBuyOrdersCount() const;
     size_t getSellOrdersCount() const;
+    std::optional<double> getBestBid() const;
+    std::optional<double> getBestAsk() const;
+    // Levels from the touch outwards (max_levels 0 = all). Same threading
+    // caveat as processOrderSync: call while the matching thread is stopped.
+    std::vector<PriceLevel> getDepth(OrderSide side, size_t max_levels = 0) const;
     const LatencyStats& getLatencyStats() const { return latency_stats_; }
+    LevelStoreType getLevelStoreType() const { return static_cast<LevelStoreType>(book_.index() / kPolicies); }
+    MatchingPolicy getMatchingPolicy() const { return static_cast<MatchingPolicy>(book_.index() % kPolicies); }
+    // Orders refused because their id is already resting or the level store
+    // cannot hold their price
+    uint64_t getRejectedCount() const;
+    // Window upkeep of the LADDER and TIERED stores, both sides together
+    LevelStoreStats getLevelStoreStats() const;
     
 private:
-    // Price-time priority maps
-    std::multimap<double, std::unique_ptr<Order>, std::greater<double>> buy_orders_;  // Highest price first
-    std::multimap<double, std::unique_ptr<Order>> sell_orders_;  // Lowest price first
+    // Gathers the current order's fills for publishFills
+    struct FillCollector {
+        std::vector<Trade>* fills;
+        
+        void onTrade(const BasicTrade<double, uint32_t>& trade) {
+            // Stamped in publishFills
+            fills->push_back(Trade{trade.buy_order_id, trade.sell_order_id, trade.price, trade.quantity, {}});
+        }
+    };
+    // Matching is BasicOrderBook's over double prices, with one alternative
+    // per store and policy: stores in LevelStoreType order, each with its
+    // policies in MatchingPolicy order. Each operation dispatches once and
+    // then runs the code compiled for that combination.
+    template<template<typename, typename, OrderSide> class Levels, typename Matching>
+    using Book = BasicOrderBook<double, uint32_t, Levels, Matching, FillCollector>;
+    template<template<typename, typename, OrderSide> class Levels>
+    using PriceTime = Book<Levels, FifoMatching>;
+    template<template<typename, typename, OrderSide> class Levels>
+    using ProRata = Book<Levels, ProRataMatching<>>;
+    template<template<typename, typename, OrderSide> class Levels>
+    using ProRataTop = Book<Levels, ProRataMatching<true>>;
+    static constexpr size_t kPolicies = 3;
+    std::variant<PriceTime<TreeLevelStore>, ProRata<TreeLevelStore>, ProRataTop<TreeLevelStore>,
+                 PriceTime<LadderLevelStore>, ProRata<LadderLevelStore>, ProRataTop<LadderLevelStore>,
+                 PriceTime<SortedLevelStore>, ProRata<SortedLevelStore>, ProRataTop<SortedLevelStore>,
+                 PriceTime<TieredLevelStore>, ProRata<TieredLevelStore>, ProRataTop<TieredLevelStore>> book_;
+    
+    // Queued request: a new order, or a cancel when order is null
+    struct OrderRequest {
+        std::unique_ptr<Order> order;
+        uint64_t cancel_id;
+    };
     
     // Thread-safe order queue
-    std::queue<std::unique_ptr<Order>> order_queue_;
+    std::queue<OrderRequest> order_queue_;
     std::mutex queue_mutex_;
     std::condition_variable queue_cv_;
     
     // Threading components
     std::thread matching_thread_;
     std::atomic<bool> running_{false};
+    int matching_cpu_{-1};
     
     TradeCallback trade_callback_;
-    MemoryPool<Order> order_pool_;
-    std::atomic<uint64_t> next_trade_id_{1};
+    TradeBatchCallback trade_batch_callback_;
+    std::vector<Trade> fills_;  // Current order's fills, reused so sweeps do not allocate
     LatencyStats latency_stats_;
     
+    // Latency outlier capture
+    OutlierCallback outlier_callback_;
+    uint64_t outlier_threshold_ns_{0};
+    
     // Thread functions
     void matchingThreadFunc();
-    void processOrder(std::unique_ptr<Order> order);
-    void matchOrders();
-    void executeTrade(Order& buy_order, Order& sell_order, uint32_t quantity);
+    template<template<typename, typename, OrderSide> class Levels>
+    void emplaceBook(const typename Levels<double, uint32_t, OrderSide::BUY>::Config& levels, MatchingPolicy matching);
+    void processOrder(std::unique_ptr<Order> order, size_t queue_depth);
+    void publishFills(const Order& incoming, const SweepStats& sweep);
 };
 
 } // namespace OrderEngine
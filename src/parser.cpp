@@ -1,7 +1,9 @@
 #include "parser.hpp"
+#include "probe.hpp"
 #include <sstream>
 #include <iostream>
 #include <cctype>
+#include <cmath>
 
 namespace OrderEngine {
 
@@ -9,6 +11,7 @@ OrderParser::OrderParser() = default;
 OrderParser::~OrderParser() = default;
 
 std::optional<std::unique_ptr<Order>> OrderParser::parseOrder(const std::string& json_str) {
+    OE_PROBE_SCOPE("parser.parse");
     try {
         // Simple JSON parsing for demo - in production use nlohmann/json
         std::string side_str, price_str, quantity_str;
@@ -20,6 +23,7 @@ std::optional<std::unique_ptr<Order>> OrderParser::parseOrder(const std::string&
         
         if (side_pos == std::string::npos || price_pos == std::string::npos || 
             quantity_pos == std::string::npos) {
+            OE_PROBE_COUNT("parser.rejected", 1);
             return std::nullopt;
         }
         
@@ -27,6 +31,7 @@ std::optional<std::unique_ptr<Order>> OrderParser::parseOrder(const std::string&
         size_t side_start = json_str.find("\"", side_pos + 7) + 1;
         size_t side_end = json_str.find("\"", side_start);
         if (side_start == std::string::npos || side_end == std::string::npos) {
+            OE_PROBE_COUNT("parser.rejected", 1);
             return std::nullopt;
         }
         side_str = json_str.substr(side_start, side_end - side_start);
@@ -39,6 +44,7 @@ std::optional<std::unique_ptr<Order>> OrderParser::parseOrder(const std::string&
         }
         size_t price_end = json_str.find_first_of(",}", price_start);
         if (price_end == std::string::npos) {
+            OE_PROBE_COUNT("parser.rejected", 1);
             return std::nullopt;
         }
         price_str = json_str.substr(price_start, price_end - price_start);
@@ -51,6 +57,7 @@ std::optional<std::unique_ptr<Order>> OrderParser::parseOrder(const std::string&
         }
         size_t quantity_end = json_str.find_first_of(",}", quantity_start);
         if (quantity_end == std::string::npos) {
+            OE_PROBE_COUNT("parser.rejected", 1);
             return std::nullopt;
         }
         quantity_str = json_str.substr(quantity_start, quantity_end - quantity_start);
@@ -64,22 +71,65 @@ std::optional<std::unique_ptr<Order>> OrderParser::parseOrder(const std::string&
         trim(price_str);
         trim(quantity_str);
 
-        // Debugging output for malformed input
-        std::cout << "Parsed side: '" << side_str << "', price: '" << price_str 
-                  << "', quantity: '" << quantity_str << "'\n";
-
         OrderSide side = parseOrderSide(side_str);
         double price = std::stod(price_str);
+        if (!std::isfinite(price)) {
+            throw std::invalid_argument("price " + price_str + " is not finite");
+        }
+        if (tick_table_ && !tick_table_->aligned(price)) {
+            throw std::invalid_argument("price " + price_str + " is off the tick grid");
+        }
         uint32_t quantity = std::stoul(quantity_str);
+        auto client_id = parseId(json_str);
+        if (client_id && *client_id >= kFirstAssignedId) {
+            throw std::invalid_argument("order id is in the server-assigned range");
+        }
+        uint64_t id = client_id ? *client_id : next_order_id_++;
         
-        return std::make_unique<Order>(next_order_id_++, side, price, quantity);
+        return std::make_unique<Order>(id, side, price, quantity);
         
     } catch (const std::exception& e) {
         std::cerr << "Error parsing order: " << e.what() << std::endl;
+        OE_PROBE_COUNT("parser.rejected", 1);
         return std::nullopt;
     }
 }
 
+std::optional<uint64_t> OrderParser::parseCancel(const std::string& json_str) {
+    size_t type_pos = json_str.find("\"type\":");
+    if (type_pos == std::string::npos) {
+        return std::nullopt;
+    }
+    size_t type_start = json_str.find("\"", type_pos + 7);
+    if (type_start == std::string::npos || json_str.compare(type_start, 8, "\"cancel\"") != 0) {
+        return std::nullopt;
+    }
+    try {
+        return parseId(json_str);
+    } catch (const std::exception& e) {
+        std::cerr << "Error parsing cancel: " << e.what() << std::endl;
+        return std::nullopt;
+    }
+}
+
+std::optional<uint64_t> OrderParser::parseId(const std::string& json_str) {
+    size_t id_pos = json_str.find("\"id\":");
+    if (id_pos == std::string::npos) {
+        return std::nullopt;
+    }
+    size_t id_start = json_str.find_first_not_of(" \t", id_pos + 5);
+    if (id_start == std::string::npos) {
+        return std::nullopt;
+    }
+    // Digits only: stoull would also take a sign and wrap -1 to 2^64-1
+    size_t id_end = json_str.find_first_not_of("0123456789", id_start);
+    std::string digits = json_str.substr(id_start, id_end - id_start);
+    if (digits.empty() || (id_end != std::string::npos && json_str.find_first_of(",} \t", id_end) != id_end)) {
+        throw std::invalid_argument("order id must be a non-negative integer");
+    }
+    return std::stoull(digits);
+}
+
 OrderSide OrderParser::parseOrderSide(const std::string& side_str) {
     if (side_str == "buy" || side_str == "BUY") {
         return OrderSide::BUY;
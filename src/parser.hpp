@@ -5,6 +5,7 @@
 #include <optional>
 #include <atomic>
 #include "order_book.hpp"
+#include "tick_table.hpp"
 
 namespace OrderEngine {
 
@@ -13,12 +14,26 @@ public:
     OrderParser();
     ~OrderParser();
     
+    // Ids the parser assigns start here. Client ids must be below it, so an
+    // assigned id never collides with one a client chose.
+    static constexpr uint64_t kFirstAssignedId = uint64_t{1} << 63;
+    
+    // New order: {"side":"buy","price":100.50,"quantity":10}. An optional
+    // "id" field supplies the order id; otherwise one is assigned.
     std::optional<std::unique_ptr<Order>> parseOrder(const std::string& json_str);
     
+    // Cancel request: {"type":"cancel","id":42}. Returns the order id.
+    std::optional<uint64_t> parseCancel(const std::string& json_str);
+    
+    // Orders priced off this instrument's tick grid are rejected from now on
+    void setTickTable(const TickTable& tick_table) { tick_table_ = tick_table; }
+    
 private:
-    std::atomic<uint64_t> next_order_id_{1};
+    std::atomic<uint64_t> next_order_id_{kFirstAssignedId};
+    std::optional<TickTable> tick_table_;
     
     OrderSide parseOrderSide(const std::string& side_str);
+    std::optional<uint64_t> parseId(const std::string& json_str);
 };
 
 } // namespace OrderEngine
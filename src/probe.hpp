@@ -0,0 +1,65 @@
+#pragma once
+
+// Probe points for timing and counting on the hot path. In the default "lean"
+// build they compile to nothing; defining OE_INSTRUMENTED (the *_instrumented
+// CMake targets) makes them record into the MetricsRegistry.
+//
+//   OE_PROBE_SCOPE("order_book.process");   // Times the enclosing scope
+//   OE_PROBE_COUNT("parser.errors", 1);     // Adds to a counter
+
+#ifdef OE_INSTRUMENTED
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "metrics.hpp"
+#endif
+
+namespace OrderEngine {
+
+#ifdef OE_INSTRUMENTED
+constexpr bool kProbesEnabled = true;
+
+class ScopedProbe {
+public:
+    explicit ScopedProbe(LatencyHistogram& histogram)
+        : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+    
+    ~ScopedProbe() {
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        histogram_.recordConcurrent(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+    
+    ScopedProbe(const ScopedProbe&) = delete;
+    ScopedProbe& operator=(const ScopedProbe&) = delete;
+    
+private:
+    LatencyHistogram& histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+#else
+constexpr bool kProbesEnabled = false;
+#endif
+
+} // namespace OrderEngine
+
+#define OE_PROBE_CONCAT_IMPL(a, b) a##b
+#define OE_PROBE_CONCAT(a, b) OE_PROBE_CONCAT_IMPL(a, b)
+
+#ifdef OE_INSTRUMENTED
+// The registry lookup runs once per call site; afterwards a probe is two clock reads
+#define OE_PROBE_SCOPE(name)                                                              \
+    static ::OrderEngine::LatencyHistogram& OE_PROBE_CONCAT(oe_probe_histogram_, __LINE__) = \
+        ::OrderEngine::MetricsRegistry::instance().histogram(name);                       \
+    ::OrderEngine::ScopedProbe OE_PROBE_CONCAT(oe_probe_, __LINE__)(               \
+        OE_PROBE_CONCAT(oe_probe_histogram_, __LINE__))
+#define OE_PROBE_COUNT(name, amount)                                                      \
+    do {                                                                                  \
+        static std::atomic<uint64_t>& oe_probe_counter =                                  \
+            ::OrderEngine::MetricsRegistry::instance().counter(name);                     \
+        oe_probe_counter.fetch_add(static_cast<uint64_t>(amount), std::memory_order_relaxed); \
+    } while (0)
+#else
+#define OE_PROBE_SCOPE(name) static_cast<void>(0)
+#define OE_PROBE_COUNT(name, amount) static_cast<void>(0)
+#endif
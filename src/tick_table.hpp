@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+
+namespace OrderEngine {
+
+// Prices from `from` up to the next band's start trade in multiples of tick
+struct TickBand {
+    double from;
+    double tick;
+};
+
+// Piecewise mapping between prices and dense level numbers for an instrument
+// whose tick size depends on the price band, e.g. 0.01 below 1.00, 0.05 up to
+// 10.00 and 0.10 above: {{0, 0.01}, {1, 0.05}, {10, 0.1}}. Levels are numbered
+// consecutively across bands, so a ladder indexes a mixed-tick book directly.
+// Each band keeps its first price, first level and the reciprocal of its tick;
+// a lookup sums one compare per band boundary into the band number and does a
+// multiply, with no division and no data-dependent branches. Prices below the
+// first band use its tick. Tables are literal types, so a static instrument's
+// table is built and checked at compile time:
+//
+//   constexpr TickTable kEquityTicks{{0, 0.0001}, {1, 0.01}};
+class TickTable {
+public:
+    static constexpr size_t kMaxBands = 8;
+
+    constexpr TickTable() = default;
+    constexpr explicit TickTable(double tick) : TickTable({{0, tick}}) {}
+
+    // Bands in ascending price order; each band must start on the grid of
+    // the one before it
+    constexpr TickTable(std::initializer_list<TickBand> bands) {
+        if (bands.size() == 0 || bands.size() > kMaxBands) {
+            throw std::invalid_argument("tick table needs 1 to 8 bands");
+        }
+        for (const TickBand& band : bands) {
+            add(band);
+        }
+    }
+
+    // Appends a band above the existing ones, for tables read at runtime
+    constexpr void add(const TickBand& band) {
+        if (count_ == kMaxBands || !(band.tick > 0)) {
+            throw std::invalid_argument("tick table band out of range");
+        }
+        int64_t first_level = 0;
+        if (count_ > 0) {
+            size_t last = count_ - 1;
+            double steps = (band.from - from_[last]) * inverse_[last];
+            if (!(band.from > from_[last]) || !representable(steps) || !near(steps, round(steps))) {
+                throw std::invalid_argument("tick table band does not start on the previous band's grid");
+            }
+            first_level = first_level_[last] + round(steps);
+        }
+        from_[count_] = band.from;
+        tick_[count_] = band.tick;
+        inverse_[count_] = 1.0 / band.tick;
+        first_level_[count_] = first_level;
+        count_++;
+    }
+
+    constexpr size_t bands() const { return count_; }
+    constexpr TickBand band(size_t index) const { return {from_[index], tick_[index]}; }
+
+    constexpr double minTick() const {
+        double tick = tick_[0];
+        for (size_t i = 1; i < count_; ++i) {
+            tick = tick_[i] < tick ? tick_[i] : tick;
+        }
+        return tick;
+    }
+
+    // Nearest level to price; true if price is on the grid. NaN, infinities
+    // and prices too far out for a level number are off the grid (level 0).
+    constexpr bool levelOf(double price, int64_t& level) const {
+        size_t band = bandOf(price);
+        double steps = (price - from_[band]) * inverse_[band];
+        if (!representable(steps)) {
+            level = 0;
+            return false;
+        }
+        int64_t rounded = round(steps);
+        level = first_level_[band] + rounded;
+        return near(steps, rounded);
+    }
+
+    constexpr int64_t levelOf(double price) const {
+        int64_t level = 0;
+        levelOf(price, level);
+        return level;
+    }
+
+    constexpr bool aligned(double price) const {
+        int64_t level = 0;
+        return levelOf(price, level);
+    }
+
+    constexpr double priceOf(int64_t level) const {
+        size_t band = 0;
+        for (size_t i = 1; i < count_; ++i) {
+            band += level >= first_level_[i];
+        }
+        return from_[band] + static_cast<double>(level - first_level_[band]) * tick_[band];
+    }
+
+private:
+    double from_[kMaxBands] = {};
+    double tick_[kMaxBands] = {};
+    double inverse_[kMaxBands] = {};
+    int64_t first_level_[kMaxBands] = {};
+    size_t count_ = 0;
+
+    constexpr size_t bandOf(double price) const {
+        size_t band = 0;
+        for (size_t i = 1; i < count_; ++i) {
+            band += price >= from_[i];
+        }
+        return band;
+    }
+
+    // Finite and far enough inside int64_t for round() and a band's first
+    // level to be added without overflow; false for NaN
+    static constexpr bool representable(double steps) {
+        constexpr double kMaxSteps = 4611686018427387904.0;  // 2^62
+        return steps > -kMaxSteps && steps < kMaxSteps;
+    }
+
+    // std::llround and std::abs are not constexpr; value must be representable
+    static constexpr int64_t round(double value) {
+        return value >= 0 ? static_cast<int64_t>(value + 0.5) : -static_cast<int64_t>(-value + 0.5);
+    }
+
+    // Within a millionth of a tick of the grid
+    static constexpr bool near(double steps, int64_t rounded) {
+        double error = steps - static_cast<double>(rounded);
+        return error <= 1e-6 && error >= -1e-6;
+    }
+};
+
+} // namespace OrderEngine
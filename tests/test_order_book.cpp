@@ -1,9 +1,22 @@
+#include <algorithm>
 #include <iostream>
 #include <cassert>
+#include <cmath>
 #include <memory>
 #include <chrono>
+#include <vector>
 #include "../src/order_book.hpp"
+#include "../src/basic_order_book.hpp"
 #include "../src/parser.hpp"
+#include "../src/histogram.hpp"
+#include "../src/occupancy_bitmap.hpp"
+#include "../src/tick_table.hpp"
+#include "../src/jitter_meter.hpp"
+#include "../src/metrics.hpp"
+#include "../src/probe.hpp"
+#include "../tools/market_generator.hpp"
+#include "../tools/event_stream.hpp"
+#include <thread>
 
 using namespace OrderEngine;
 
@@ -16,6 +29,7 @@ void testBasicOrderMatching() {
         assert(trade.price == 100.0);
         assert(trade.quantity == 5);
     });
+    order_book.start();
     
     // Add buy order
     auto buy_order = std::make_unique<Order>(1, OrderSide::BUY, 100.0, 10);
@@ -24,6 +38,7 @@ void testBasicOrderMatching() {
     // Add matching sell order
     auto sell_order = std::make_unique<Order>(2, OrderSide::SELL, 100.0, 5);
     order_book.submitOrder(std::move(sell_order));
+    order_book.stop();  // Drains the queue before joining
     
     assert(trade_executed);
     assert(order_book.getBuyOrdersCount() == 1);  // Partial fill
@@ -57,6 +72,7 @@ void testPriceTimePriority() {
             assert(trade.price == 99.0);
         }
     });
+    order_book.start();
     
     // Add buy order at 100
     auto buy_order = std::make_unique<Order>(1, OrderSide::BUY, 100.0, 10);
@@ -68,6 +84,7 @@ void testPriceTimePriority() {
     
     order_book.submitOrder(std::move(sell_order1));
     order_book.submitOrder(std::move(sell_order2));  // This should match first
+    order_book.stop();
     
     assert(trade_count == 1);
     
@@ -82,6 +99,7 @@ void testPerformanceBenchmark() {
     order_book.setTradeCallback([&trade_executed](const Trade&) {
         trade_executed = true;
     });
+    order_book.start();
 
     auto start_time = std::chrono::high_resolution_clock::now();
 
@@ -89,6 +107,9 @@ void testPerformanceBenchmark() {
         auto buy_order = std::make_unique<Order>(i, OrderSide::BUY, 100.0 + i * 0.01, 10);
         order_book.submitOrder(std::move(buy_order));
     }
+    // Cross the best bid so the run ends with a trade
+    order_book.submitOrder(std::make_unique<Order>(num_orders, OrderSide::SELL, 100.0, 10));
+    order_book.stop();
 
     auto end_time = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
@@ -98,6 +119,672 @@ void testPerformanceBenchmark() {
     std::cout << "testPerformanceBenchmark: PASSED\n";
 }
 
+void testLatencyOutlierCapture() {
+    OrderBook order_book;
+    std::vector<LatencyOutlier> outliers;
+    
+    // 1ns threshold: every order is reported
+    order_book.setLatencyOutlierThreshold(1);
+    order_book.setOutlierCallback([&outliers](const LatencyOutlier& outlier) {
+        outliers.push_back(outlier);
+    });
+    order_book.start();
+    
+    order_book.submitOrder(std::make_unique<Order>(1, OrderSide::SELL, 100.0, 5));
+    order_book.submitOrder(std::make_unique<Order>(2, OrderSide::SELL, 100.0, 5));
+    order_book.submitOrder(std::make_unique<Order>(3, OrderSide::SELL, 101.0, 5));
+    order_book.submitOrder(std::make_unique<Order>(4, OrderSide::BUY, 101.0, 12));
+    order_book.stop();
+    
+    assert(outliers.size() == 4);
+    const auto& sweep = outliers.back();
+    assert(sweep.order_id == 4);
+    assert(sweep.side == OrderSide::BUY);
+    assert(sweep.price == 101.0);
+    assert(sweep.levels_swept == 2);
+    assert(sweep.orders_swept == 3);
+    assert(sweep.latency_ns >= 1);
+    assert(outliers.front().orders_swept == 0);
+    
+    std::cout << "testLatencyOutlierCapture: PASSED\n";
+}
+
+void testParserClientIdAndCancel() {
+    OrderParser parser;
+    
+    auto order = parser.parseOrder(R"({"id":77,"side":"sell","price":101.25,"quantity":3,"ts":5})");
+    assert(order.has_value());
+    assert((*order)->id == 77);
+    assert((*order)->side == OrderSide::SELL);
+    assert((*order)->price == 101.25);
+    
+    auto cancel = parser.parseCancel(R"({"type":"cancel","id":77})");
+    assert(cancel.has_value() && *cancel == 77);
+    assert(!parser.parseCancel(R"({"side":"buy","price":100.50,"quantity":10})"));
+    assert(!parser.parseCancel(R"({"type":"cancel"})"));
+    assert(!parser.parseCancel(R"({"type":"cancel","id":-1})"));
+    assert(!parser.parseCancel(R"({"type":"cancel","id":12ab})"));
+    assert(!parser.parseOrder(R"({"id":-1,"side":"sell","price":101.25,"quantity":3})"));
+    assert(!parser.parseOrder(R"({"id":9223372036854775808,"side":"sell","price":101.25,"quantity":3})"));
+    
+    // Assigned ids sit above every client id
+    auto assigned = parser.parseOrder(R"({"side":"buy","price":100.50,"quantity":10})");
+    assert(assigned && (*assigned)->id >= OrderParser::kFirstAssignedId);
+    
+    std::cout << "testParserClientIdAndCancel: PASSED\n";
+}
+
+void testCancelOrder() {
+    OrderBook order_book;
+    int trade_count = 0;
+    order_book.setTradeCallback([&trade_count](const Trade& trade) {
+        trade_count++;
+        assert(trade.sell_order_id == 3);  // Order 2 was cancelled
+    });
+    
+    order_book.processOrderSync(std::make_unique<Order>(1, OrderSide::BUY, 99.0, 10));
+    order_book.processOrderSync(std::make_unique<Order>(2, OrderSide::SELL, 101.0, 10));
+    order_book.processOrderSync(std::make_unique<Order>(3, OrderSide::SELL, 101.0, 10));
+    
+    bool cancelled = order_book.cancelOrderSync(2);
+    bool cancelled_again = order_book.cancelOrderSync(2);  // Already cancelled
+    bool unknown = order_book.cancelOrderSync(42);
+    assert(cancelled && !cancelled_again && !unknown);
+    assert(order_book.getSellOrdersCount() == 1);
+    
+    // A second order under a resting id is refused; the first stays cancellable
+    order_book.processOrderSync(std::make_unique<Order>(3, OrderSide::SELL, 102.0, 10));
+    assert(order_book.getSellOrdersCount() == 1 && order_book.getRejectedCount() == 1);
+    
+    order_book.processOrderSync(std::make_unique<Order>(4, OrderSide::BUY, 101.0, 10));
+    assert(trade_count == 1);
+    bool filled = order_book.cancelOrderSync(3);
+    assert(!filled);
+    assert(order_book.getBestBid() == 99.0);
+    cancelled = order_book.cancelOrderSync(1);
+    assert(cancelled);
+    assert(!order_book.getBestBid());
+    assert(!order_book.getBestAsk());
+    assert(order_book.getBuyOrdersCount() == 0);
+    assert(order_book.getSellOrdersCount() == 0);
+    
+    std::cout << "testCancelOrder: PASSED\n";
+}
+
+void testOrderBookDepth() {
+    OrderBook order_book;
+    order_book.processOrderSync(std::make_unique<Order>(1, OrderSide::BUY, 99.0, 10));
+    order_book.processOrderSync(std::make_unique<Order>(2, OrderSide::BUY, 99.5, 5));
+    order_book.processOrderSync(std::make_unique<Order>(3, OrderSide::BUY, 99.0, 7));
+    order_book.processOrderSync(std::make_unique<Order>(4, OrderSide::SELL, 101.0, 3));
+    
+    auto bids = order_book.getDepth(OrderSide::BUY);
+    assert(bids.size() == 2);
+    assert(bids[0].price == 99.5 && bids[0].quantity == 5 && bids[0].orders == 1);
+    assert(bids[1].price == 99.0 && bids[1].quantity == 17 && bids[1].orders == 2);
+    assert(order_book.getDepth(OrderSide::BUY, 1).size() == 1);
+    auto asks = order_book.getDepth(OrderSide::SELL);
+    assert(asks.size() == 1 && asks[0].price == 101.0 && asks[0].quantity == 3);
+    
+    std::cout << "testOrderBookDepth: PASSED\n";
+}
+
+void testMatchOnArrival() {
+    OrderBook order_book;
+    std::vector<Trade> trades;
+    order_book.setTradeCallback([&trades](const Trade& trade) { trades.push_back(trade); });
+    order_book.processOrderSync(std::make_unique<Order>(1, OrderSide::SELL, 100.0, 5));
+    order_book.processOrderSync(std::make_unique<Order>(2, OrderSide::SELL, 101.0, 5));
+    
+    // Sweeps one level and part of the next; a filled aggressor never rests
+    order_book.processOrderSync(std::make_unique<Order>(3, OrderSide::BUY, 101.0, 7));
+    assert(trades.size() == 2);
+    assert(trades[0].sell_order_id == 1 && trades[0].price == 100.0 && trades[0].quantity == 5);
+    assert(trades[1].sell_order_id == 2 && trades[1].price == 101.0 && trades[1].quantity == 2);
+    bool rested = order_book.cancelOrderSync(3);
+    assert(order_book.getBuyOrdersCount() == 0 && !rested);
+    
+    // Below the best ask: rests without trading
+    order_book.processOrderSync(std::make_unique<Order>(4, OrderSide::BUY, 100.5, 4));
+    assert(trades.size() == 2 && order_book.getBestBid() == 100.5);
+    
+    // Only the residual of a partially filled aggressor rests
+    order_book.processOrderSync(std::make_unique<Order>(5, OrderSide::SELL, 100.0, 10));
+    assert(trades.size() == 3 && trades[2].buy_order_id == 4 && trades[2].quantity == 4);
+    auto asks = order_book.getDepth(OrderSide::SELL);
+    assert(asks.size() == 2 && asks[0].price == 100.0 && asks[0].quantity == 6);
+    rested = order_book.cancelOrderSync(5);
+    assert(rested);
+    
+    std::cout << "testMatchOnArrival: PASSED\n";
+}
+
+void testTradeBatch() {
+    OrderBook order_book;
+    std::vector<TradeBatch> batches;
+    std::vector<Trade> fills;
+    size_t trade_callbacks = 0;
+    order_book.setTradeBatchCallback([&](const TradeBatch& batch) {
+        batches.push_back(batch);
+        fills.assign(batch.fills, batch.fills + batch.fill_count);
+    });
+    order_book.setTradeCallback([&trade_callbacks](const Trade&) { trade_callbacks++; });
+    for (uint64_t id = 1; id <= 3; ++id) {
+        order_book.processOrderSync(std::make_unique<Order>(id, OrderSide::SELL, 100.0 + id, 5));
+    }
+    assert(batches.empty());
+    
+    // Sweeps three levels: one batch, one timestamp, fills in match order
+    order_book.processOrderSync(std::make_unique<Order>(10, OrderSide::BUY, 105.0, 12));
+    assert(batches.size() == 1 && trade_callbacks == 3);
+    const TradeBatch& batch = batches[0];
+    assert(batch.aggressor_id == 10 && batch.aggressor_side == OrderSide::BUY);
+    assert(batch.filled_quantity == 12 && batch.leaves_quantity == 0 && batch.levels_swept == 3);
+    assert(batch.notional == 101.0 * 5 + 102.0 * 5 + 103.0 * 2);
+    assert(fills.size() == 3);
+    for (size_t i = 0; i < fills.size(); ++i) {
+        assert(fills[i].sell_order_id == i + 1 && fills[i].timestamp == batch.timestamp);
+    }
+    assert(fills[2].quantity == 2);
+    
+    std::cout << "testTradeBatch: PASSED\n";
+}
+
+void testOccupancyBitmap() {
+    OccupancyBitmap bitmap(300000);  // Four layers
+    assert(bitmap.first() == OccupancyBitmap::npos && bitmap.last() == OccupancyBitmap::npos);
+    for (size_t slot : {5ul, 64ul, 4095ul, 4096ul, 299999ul}) {
+        bitmap.set(slot);
+    }
+    assert(bitmap.first() == 5 && bitmap.last() == 299999);
+    assert(bitmap.findNext(6) == 64 && bitmap.findNext(65) == 4095 && bitmap.findNext(4097) == 299999);
+    assert(bitmap.findPrev(299998) == 4096 && bitmap.findPrev(4095) == 4095 && bitmap.findPrev(63) == 5);
+    assert(bitmap.findPrev(4) == OccupancyBitmap::npos);
+    bitmap.clear(4096);
+    bitmap.clear(4095);
+    assert(bitmap.findNext(65) == 299999 && bitmap.findPrev(299998) == 64);
+    assert(!bitmap.test(4095) && bitmap.test(64));
+    
+    std::cout << "testOccupancyBitmap: PASSED\n";
+}
+
+void testLadderBook() {
+    OrderBookConfig config;
+    config.level_store = LevelStoreType::LADDER;
+    config.ladder.tick_size = 0.01;
+    config.ladder.levels = 100000;
+    config.ladder.base_price = 50.0;
+    OrderBook order_book(config);
+    std::vector<Trade> trades;
+    order_book.setTradeCallback([&trades](const Trade& trade) { trades.push_back(trade); });
+    
+    // Thin asks thousands of ticks apart
+    order_book.processOrderSync(std::make_unique<Order>(1, OrderSide::SELL, 100.0, 5));
+    order_book.processOrderSync(std::make_unique<Order>(2, OrderSide::SELL, 130.0, 5));
+    order_book.processOrderSync(std::make_unique<Order>(3, OrderSide::SELL, 100.0, 5));
+    order_book.processOrderSync(std::make_unique<Order>(4, OrderSide::BUY, 60.0, 5));
+    assert(order_book.getBestAsk() == 100.0 && order_book.getBestBid() == 60.0);
+    
+    // Emptying the touch finds the next level across the gap; FIFO within a level
+    order_book.processOrderSync(std::make_unique<Order>(5, OrderSide::BUY, 100.0, 10));
+    assert(trades.size() == 2 && trades[0].sell_order_id == 1 && trades[1].sell_order_id == 3);
+    assert(order_book.getBestAsk() == 130.0);
+    bool cancelled = order_book.cancelOrderSync(4);
+    assert(cancelled && !order_book.getBestBid());
+    auto asks = order_book.getDepth(OrderSide::SELL);
+    assert(asks.size() == 1 && asks[0].price == 130.0 && asks[0].orders == 1);
+    
+    // Off the tick grid or outside the window: refused whole, even if it could trade
+    order_book.processOrderSync(std::make_unique<Order>(6, OrderSide::BUY, 100.005, 5));
+    order_book.processOrderSync(std::make_unique<Order>(7, OrderSide::BUY, 2000.0, 2));
+    assert(trades.size() == 2);
+    order_book.processOrderSync(std::make_unique<Order>(8, OrderSide::SELL, 1100.0, 1));
+    assert(order_book.getRejectedCount() == 3 && order_book.getBuyOrdersCount() == 0);
+    assert(order_book.getSellOrdersCount() == 1);
+    
+    std::cout << "testLadderBook: PASSED\n";
+}
+
+void testSortedBook() {
+    OrderBookConfig config;
+    config.level_store = LevelStoreType::SORTED;
+    OrderBook order_book(config);
+    
+    // Any price, however far apart; levels are created and removed in the middle
+    const double prices[] = {0.0001, 250000.0, 99.5, 1e-8, 100.0, 99.5, 3.25};
+    for (uint64_t id = 0; id < 7; ++id) {
+        order_book.processOrderSync(std::make_unique<Order>(id + 1, OrderSide::BUY, prices[id], 1));
+    }
+    auto bids = order_book.getDepth(OrderSide::BUY);
+    assert(bids.size() == 6 && bids[0].price == 250000.0 && bids[5].price == 1e-8);
+    assert(bids[2].price == 99.5 && bids[2].orders == 2);
+    bool cancelled_5 = order_book.cancelOrderSync(5);
+    bool cancelled_7 = order_book.cancelOrderSync(7);
+    assert(cancelled_5 && cancelled_7);
+    bids = order_book.getDepth(OrderSide::BUY);
+    assert(bids.size() == 4 && bids[1].price == 99.5 && bids[2].price == 0.0001);
+    
+    // A sell walks down from the touch, FIFO within a price
+    std::vector<uint64_t> filled;
+    order_book.setTradeCallback([&filled](const Trade& trade) { filled.push_back(trade.buy_order_id); });
+    order_book.processOrderSync(std::make_unique<Order>(8, OrderSide::SELL, 50.0, 3));
+    assert((filled == std::vector<uint64_t>{2, 3, 6}));
+    assert(order_book.getBestBid() == 0.0001 && order_book.getBuyOrdersCount() == 2);
+    
+    std::cout << "testSortedBook: PASSED\n";
+}
+
+// Fills the earliest order at a store's touch, as matching does
+template<typename Store>
+void fillBestOrder(Store& store) {
+    auto& level = store.bestLevel();
+    level.popFront();
+    if (level.empty()) {
+        store.popBestLevel();
+    }
+}
+
+template<typename Store>
+size_t restingOrders(const Store& store) {
+    std::vector<PriceLevel> depth;
+    store.appendDepth(depth, 0);
+    size_t orders = 0;
+    for (const auto& level : depth) {
+        orders += level.orders;
+    }
+    return orders;
+}
+
+void testSortedLevelStore() {
+    // Enough levels, added out of order, for blocks to split many times over
+    SortedLevelStore<double, uint32_t, OrderSide::SELL> asks;
+    auto priceOf = [](uint64_t id) { return 100.0 + static_cast<double>((id * 389) % 1000) / 2; };
+    size_t added = 0;
+    for (uint64_t id = 0; id < 1000; ++id) {
+        added += asks.add(priceOf(id), id, 1);
+    }
+    assert(added == 1000);
+    auto ascending = [](const PriceLevel& a, const PriceLevel& b) { return a.price < b.price; };
+    std::vector<PriceLevel> depth;
+    asks.appendDepth(depth, 0);
+    assert(depth.size() == 1000 && depth.front().price == 100.0 && depth.back().price == 599.5);
+    assert(std::is_sorted(depth.begin(), depth.end(), ascending));
+    
+    // Cancelling nine levels in ten merges the blocks that run low
+    size_t cancelled = 0;
+    for (uint64_t id = 0; id < 1000; ++id) {
+        if ((id * 389) % 1000 % 10 != 0) {
+            cancelled += asks.cancel(priceOf(id), id);
+            cancelled += asks.cancel(priceOf(id), id);  // Already gone
+        }
+    }
+    assert(cancelled == 900);
+    depth.clear();
+    asks.appendDepth(depth, 0);
+    assert(depth.size() == 100 && depth[1].price == 105.0 && std::is_sorted(depth.begin(), depth.end(), ascending));
+    
+    // Extraction hands levels over best first and leaves the rest in order
+    std::vector<double> taken;
+    asks.extractLevels(200.0, 300.0, [&](LevelQueue<double, uint32_t>&& level) { taken.push_back(level.price); });
+    assert(taken.size() == 21 && taken.front() == 200.0 && taken.back() == 300.0);
+    std::vector<double> touches;
+    while (!asks.empty()) {
+        touches.push_back(asks.bestPrice());
+        fillBestOrder(asks);
+    }
+    assert(touches.size() == 79 && std::is_sorted(touches.begin(), touches.end()) && touches[20] == 305.0);
+    
+    std::cout << "testSortedLevelStore: PASSED\n";
+}
+
+void testTieredLevelStore() {
+    TieredConfig config;
+    config.tick_size = 1.0;
+    config.window = 8;  // Touch kept 2 slots in
+    TieredLevelStore<double, uint32_t, OrderSide::BUY> bids(config);
+    uint64_t id = 1;
+    size_t rested = 0;
+    auto bid = [&](double price) { rested += bids.add(price, id++, 1); };
+    
+    // Window 95..102 around the first bid; far bids go cold
+    bid(100);
+    bid(96);
+    bid(90);
+    bid(50);
+    assert(rested == 4 && restingOrders(bids) == 4 && bids.promotions() == 0);
+    
+    // A better bid moves the window up 5 ticks, touching only the 5 slots
+    // that change tick, and demotes 96
+    bid(105);
+    assert(rested == 5 && bids.bestPrice() == 105);
+    assert(bids.demotions() == 1 && bids.stats().slots_moved == 5);
+    std::vector<PriceLevel> depth;
+    bids.appendDepth(depth, 0);
+    assert(depth.size() == 5 && depth[2].price == 96 && depth[4].price == 50);
+    
+    // Filling down the book promotes each far level as the touch reaches it
+    std::vector<double> touches;
+    while (!bids.empty()) {
+        touches.push_back(bids.bestPrice());
+        fillBestOrder(bids);
+    }
+    assert((touches == std::vector<double>{105, 100, 96, 90, 50}));
+    assert(bids.promotions() == 3 && restingOrders(bids) == 0);
+    bool off_grid = bids.add(99.5, id++, 1);
+    assert(!bids.accepts(99.5) && !off_grid);
+    
+    // Two spellings of one tick share a cold level: both cancel and both trade
+    config.tick_size = 0.01;
+    BasicOrderBook<double, uint32_t, TieredLevelStore> book(config);
+    uint32_t traded = 0;
+    book.listener().callback = [&](const BasicOrderBook<>::Trade& trade) { traded += trade.quantity; };
+    book.submit(1, OrderSide::BUY, 100.0, 1);
+    book.submit(2, OrderSide::BUY, 90.0, 5);
+    book.submit(3, OrderSide::BUY, 90.0000000001, 7);
+    book.submit(4, OrderSide::BUY, 90.0000000001, 2);
+    bool cancelled = book.cancel(4);
+    book.submit(5, OrderSide::SELL, 80.0, 100);
+    assert(cancelled && traded == 13 && book.orderCount(OrderSide::BUY) == 0 && book.bestAsk() == 80.0);
+    
+    std::cout << "testTieredLevelStore: PASSED\n";
+}
+
+void testRecenteringLadder() {
+    LadderConfig config;
+    config.tick_size = 1.0;
+    config.levels = 16;
+    using Asks = LadderLevelStore<double, uint32_t, OrderSide::SELL>;
+    Asks fixed(config);
+    config.recenter_step = 2;
+    Asks asks(config);
+    uint64_t id = 1;
+    auto ask = [&](Asks& store, double price) { return store.add(price, id++, 1); };
+    
+    // Window 92..107 around the first ask; the fixed ladder cannot take 120
+    bool fixed_100 = ask(fixed, 100);
+    bool fixed_120 = ask(fixed, 120);
+    assert(fixed_100 && !fixed.accepts(120) && !fixed_120);
+    uint64_t at_100 = id;
+    size_t rested = ask(asks, 100);
+    rested += ask(asks, 120);
+    uint64_t spelled = id;
+    rested += ask(asks, 100.0000001);  // Another spelling of tick 100
+    
+    // The market trends 40 ticks down; the window follows a step at a time
+    for (int tick = 1; tick <= 40; ++tick) {
+        rested += ask(asks, 100 - tick);
+    }
+    bool fixed_60 = ask(fixed, 60);
+    LevelStoreStats stats = asks.stats();
+    assert(rested == 43 && !fixed_60 && restingOrders(asks) == 43 && asks.bestPrice() == 60);
+    assert(stats.window_moves >= 15 && stats.slots_moved <= stats.window_moves * 2 && stats.levels_migrated > 0);
+    
+    // Levels left behind in the overflow are still found, under any spelling, in price order
+    bool cancelled_spelled = asks.cancel(100.0000001, spelled);
+    bool cancelled = asks.cancel(100, at_100);
+    bool cancelled_again = asks.cancel(100, at_100);
+    assert(cancelled_spelled && cancelled && !cancelled_again);
+    std::vector<PriceLevel> depth;
+    asks.appendDepth(depth, 0);
+    assert(depth.size() == 41 && depth.front().price == 60 && depth[39].price == 99 && depth.back().price == 120);
+    
+    // Filling up the book brings them back into the window
+    std::vector<double> touches;
+    while (!asks.empty()) {
+        touches.push_back(asks.bestPrice());
+        fillBestOrder(asks);
+    }
+    assert(touches.size() == 41 && std::is_sorted(touches.begin(), touches.end()) && touches.back() == 120);
+    assert(asks.stats().window_moves > stats.window_moves);
+    
+    std::cout << "testRecenteringLadder: PASSED\n";
+}
+
+void testTickTable() {
+    // Checked at compile time: levels run on across the band boundaries
+    constexpr TickTable kTicks{{0, 0.01}, {1, 0.05}, {10, 0.1}};
+    static_assert(kTicks.bands() == 3 && kTicks.minTick() == 0.01, "bands");
+    static_assert(kTicks.levelOf(0.99) == 99 && kTicks.levelOf(1.0) == 100 && kTicks.levelOf(1.05) == 101, "low bands");
+    static_assert(kTicks.levelOf(10.0) == 280 && kTicks.levelOf(10.1) == 281, "top band");
+    static_assert(kTicks.aligned(0.37) && !kTicks.aligned(1.02) && !kTicks.aligned(10.05), "alignment");
+    static_assert(!kTicks.aligned(1e300) && !kTicks.aligned(-1e300), "beyond any level number");
+    assert(!kTicks.aligned(std::nan("")) && !kTicks.aligned(HUGE_VAL));
+    for (int64_t level = 0; level < 400; ++level) {
+        assert(kTicks.levelOf(kTicks.priceOf(level)) == level && kTicks.aligned(kTicks.priceOf(level)));
+    }
+    
+    // A band must start on the grid of the one below it
+    bool threw = false;
+    try {
+        TickTable{{0, 0.05}, {1.02, 0.1}};
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    // The parser rejects prices off the grid
+    OrderParser parser;
+    parser.setTickTable(kTicks);
+    assert(parser.parseOrder(R"({"side":"buy","price":1.05,"quantity":1})"));
+    assert(!parser.parseOrder(R"({"side":"buy","price":1.02,"quantity":1})"));
+    assert(!parser.parseOrder(R"({"side":"buy","price":1e300,"quantity":1})"));
+    assert(!OrderParser().parseOrder(R"({"side":"buy","price":nan,"quantity":1})"));
+    
+    // One ladder spans all three bands, with neighbouring levels in adjacent slots
+    LadderConfig config;
+    config.tick_table = kTicks;
+    config.levels = 512;
+    config.base_price = 0.01;
+    LadderLevelStore<double, uint32_t, OrderSide::SELL> asks(config);
+    uint64_t id = 1;
+    size_t rested = 0;
+    for (double price : {10.1, 0.99, 1.05, 1.0}) {
+        rested += asks.add(price, id++, 1);
+    }
+    bool off_grid = asks.add(1.02, id++, 1);
+    assert(rested == 4 && !off_grid);
+    std::vector<double> touches;
+    while (!asks.empty()) {
+        touches.push_back(asks.bestPrice());
+        fillBestOrder(asks);
+    }
+    assert((touches == std::vector<double>{0.99, 1.0, 1.05, 10.1}));
+    
+    std::cout << "testTickTable: PASSED\n";
+}
+
+struct TradeTally {
+    uint64_t trades = 0;
+    uint64_t quantity = 0;
+    
+    template<typename Trade>
+    void onTrade(const Trade& trade) {
+        trades++;
+        quantity += trade.quantity;
+    }
+};
+
+void testBasicOrderBook() {
+    // The default instantiation trades OrderBook's prices and quantities
+    static_assert(std::is_same_v<BasicOrderBook<>::price_type, double> &&
+                  std::is_same_v<BasicOrderBook<>::quantity_type, uint32_t>, "defaults");
+    BasicOrderBook<> book;
+    std::vector<BasicOrderBook<>::Trade> trades;
+    book.listener().callback = [&](const BasicOrderBook<>::Trade& trade) { trades.push_back(trade); };
+    book.submit(1, OrderSide::SELL, 100.5, 10);
+    book.submit(2, OrderSide::SELL, 100.0, 10);
+    book.submit(3, OrderSide::BUY, 101.0, 15);
+    assert(trades.size() == 2 && trades[0].sell_order_id == 2 && trades[0].price == 100.0);
+    assert(trades[1].sell_order_id == 1 && trades[1].quantity == 5 && trades[1].price == 100.5);
+    assert(book.bestAsk() == 100.5 && !book.bestBid() && book.orderCount(OrderSide::SELL) == 1);
+    bool duplicate = book.submit(1, OrderSide::SELL, 102.0, 5);  // Id 1 is resting
+    assert(!duplicate && book.rejectedCount() == 1);
+    bool cancelled = book.cancel(1);
+    bool cancelled_again = book.cancel(1);
+    bool filled = book.cancel(2);
+    assert(cancelled && !cancelled_again && !filled);
+    
+    // Integer ticks on a dense ladder, trades counted inline
+    using TickBook = BasicOrderBook<int32_t, uint32_t, LadderLevelStore, FifoMatching, TradeTally>;
+    LadderConfig ladder;
+    ladder.levels = 100;
+    ladder.base_price = 10000;
+    TickBook ticks(ladder);
+    bool first = ticks.submit(1, OrderSide::BUY, 10050, 10);
+    bool second = ticks.submit(2, OrderSide::BUY, 10050, 10);
+    bool outside = ticks.submit(3, OrderSide::BUY, 10100, 10);  // Outside the window
+    assert(first && second && !outside && ticks.rejectedCount() == 1);
+    ticks.submit(4, OrderSide::SELL, 10040, 15);
+    assert(ticks.listener().trades == 2 && ticks.listener().quantity == 15);
+    assert(ticks.bestBid() == 10050 && ticks.orderCount(OrderSide::BUY) == 1 && !ticks.bestAsk());
+    
+    std::cout << "testBasicOrderBook: PASSED\n";
+}
+
+template<typename Matching>
+std::vector<std::pair<uint64_t, uint32_t>> proRataFills(const std::vector<uint32_t>& resting, uint32_t incoming) {
+    BasicOrderBook<double, uint32_t, TreeLevelStore, Matching> book;
+    std::vector<std::pair<uint64_t, uint32_t>> fills;
+    book.listener().callback = [&](const auto& trade) { fills.emplace_back(trade.buy_order_id, trade.quantity); };
+    uint64_t id = 1;
+    for (uint32_t quantity : resting) {
+        book.submit(id++, OrderSide::BUY, 100.0, quantity);
+    }
+    book.submit(id, OrderSide::SELL, 100.0, incoming);
+    return fills;
+}
+
+void testProRataMatching() {
+    using Fills = std::vector<std::pair<uint64_t, uint32_t>>;
+    // Shares in proportion to size, in time order
+    assert((proRataFills<ProRataMatching<>>({10, 30, 60}, 50) == Fills{{1, 5}, {2, 15}, {3, 30}}));
+    // Rounding leaves one lot, which goes to the earliest order
+    assert((proRataFills<ProRataMatching<>>({10, 10, 10}, 10) == Fills{{1, 4}, {2, 3}, {3, 3}}));
+    // An order too small for a whole lot only gets one from the remainder
+    assert((proRataFills<ProRataMatching<>>({1, 1, 98}, 50) == Fills{{1, 1}, {3, 49}}));
+    // Top order priority: the earliest fills first, the rest is shared
+    assert((proRataFills<ProRataMatching<true>>({10, 30, 60}, 50) == Fills{{1, 10}, {2, 14}, {3, 26}}));
+    // A level that fills completely fills in time order
+    assert((proRataFills<ProRataMatching<>>({10, 30}, 70) == Fills{{1, 10}, {2, 30}}));
+    
+    // Filled orders leave the level and the rest keep their place
+    BasicOrderBook<double, uint32_t, TreeLevelStore, ProRataMatching<>> book;
+    book.submit(1, OrderSide::SELL, 101.0, 1);
+    book.submit(2, OrderSide::SELL, 101.0, 9);
+    book.submit(3, OrderSide::BUY, 101.0, 5);
+    assert(book.orderCount(OrderSide::SELL) == 1);
+    bool filled = book.cancel(1);
+    bool cancelled = book.cancel(2);
+    assert(!filled && cancelled && !book.bestAsk());
+    
+    // OrderBook takes the policy from its config, over any level store
+    OrderBookConfig config;
+    config.level_store = LevelStoreType::SORTED;
+    config.matching = MatchingPolicy::PRO_RATA_TOP;
+    OrderBook order_book(config);
+    assert(order_book.getLevelStoreType() == LevelStoreType::SORTED &&
+           order_book.getMatchingPolicy() == MatchingPolicy::PRO_RATA_TOP);
+    Fills fills;
+    order_book.setTradeCallback([&](const Trade& trade) { fills.emplace_back(trade.buy_order_id, trade.quantity); });
+    order_book.processOrderSync(std::make_unique<Order>(1, OrderSide::BUY, 100.0, 10));
+    order_book.processOrderSync(std::make_unique<Order>(2, OrderSide::BUY, 100.0, 30));
+    order_book.processOrderSync(std::make_unique<Order>(3, OrderSide::BUY, 100.0, 60));
+    order_book.processOrderSync(std::make_unique<Order>(4, OrderSide::SELL, 100.0, 50));
+    assert((fills == Fills{{1, 10}, {2, 14}, {3, 26}}) && order_book.getBuyOrdersCount() == 2);
+    
+    std::cout << "testProRataMatching: PASSED\n";
+}
+
+void testMarketGenerator() {
+    GeneratorConfig config;
+    config.seed = 7;
+    config.cancel_ratio = 0.5;
+    MarketGenerator first(config);
+    MarketGenerator second(config);
+    config.seed = 8;
+    MarketGenerator other(config);
+    
+    OrderParser parser;
+    bool diverged = false;
+    uint64_t last_ts = 0;
+    size_t cancels = 0;
+    for (int i = 0; i < 10000; ++i) {
+        MarketEvent a = first.next();
+        MarketEvent b = second.next();
+        MarketEvent c = other.next();
+        // Same seed, same stream
+        assert(a.timestamp_ns == b.timestamp_ns && a.order_id == b.order_id &&
+               a.type == b.type && a.price == b.price && a.quantity == b.quantity);
+        diverged |= a.price != c.price || a.timestamp_ns != c.timestamp_ns;
+        assert(a.timestamp_ns >= last_ts);
+        last_ts = a.timestamp_ns;
+        
+        // The JSON form round-trips through the engine's parser
+        std::string json = formatEventJson(a, config.priceDecimals());
+        if (a.type == EventType::CANCEL) {
+            cancels++;
+            assert(parser.parseCancel(json) == a.order_id);
+        } else {
+            assert(a.price > 0.0 && a.quantity > 0);
+            auto order = parser.parseOrder(json);
+            assert(order && (*order)->id == a.order_id && (*order)->price == a.price);
+        }
+    }
+    assert(diverged);
+    assert(cancels > 3000 && cancels < 7000);
+    
+    std::cout << "testMarketGenerator: PASSED\n";
+}
+
+void testLatencyHistogram() {
+    LatencyHistogram histogram;
+    for (uint64_t value = 1; value <= 1000; ++value) {
+        histogram.record(value * 1000);  // 1µs .. 1ms
+    }
+    
+    assert(histogram.getCount() == 1000);
+    assert(histogram.getMax() == 1000000);
+    // Buckets are within ~6% of the true value
+    uint64_t p50 = histogram.getPercentile(50.0);
+    uint64_t p99 = histogram.getPercentile(99.0);
+    assert(p50 >= 500000 && p50 <= 500000 * 107 / 100);
+    assert(p99 >= 990000 && p99 <= 1000000);
+    assert(histogram.getPercentile(100.0) == 1000000);
+    assert(histogram.getCountAbove(2000000) == 0);
+    
+    std::cout << "testLatencyHistogram: PASSED\n";
+}
+
+void testJitterMeter() {
+    JitterMeter meter(-1, 1000);
+    meter.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    meter.stop();
+    
+    const auto& gaps = meter.getHistogram();
+    assert(gaps.getCount() > 0);
+    assert(gaps.getPercentile(50.0) <= gaps.getMax());
+    assert(meter.getHiccupCount() <= gaps.getCount());
+    
+    std::cout << "testJitterMeter: PASSED\n";
+}
+
+void testProbes() {
+    auto& registry = MetricsRegistry::instance();
+    registry.reset();
+    
+    OrderBook order_book;
+    order_book.processOrderSync(std::make_unique<Order>(1, OrderSide::SELL, 100.0, 5));
+    order_book.processOrderSync(std::make_unique<Order>(2, OrderSide::BUY, 100.0, 5));
+    
+    // Lean builds compile the probes out; instrumented builds record every call
+    uint64_t expected = kProbesEnabled ? 2 : 0;
+    assert(registry.histogram("order_book.process").getCount() == expected);
+    assert(registry.counter("order_book.trades").load() == expected / 2);
+    
+    std::cout << "testProbes: PASSED\n";
+}
+
 int main() {
     std::cout << "Running Order Book Engine Tests...\n\n";
     
@@ -105,6 +792,25 @@ int main() {
     testOrderParser();
     testPriceTimePriority();
     testPerformanceBenchmark();
+    testLatencyOutlierCapture();
+    testParserClientIdAndCancel();
+    testCancelOrder();
+    testOrderBookDepth();
+    testMatchOnArrival();
+    testTradeBatch();
+    testOccupancyBitmap();
+    testLadderBook();
+    testSortedBook();
+    testSortedLevelStore();
+    testTieredLevelStore();
+    testRecenteringLadder();
+    testTickTable();
+    testBasicOrderBook();
+    testProRataMatching();
+    testMarketGenerator();
+    testLatencyHistogram();
+    testJitterMeter();
+    testProbes();
     
     std::cout << "\nAll tests passed!\n";
     return 0;
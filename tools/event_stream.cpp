@@ -0,0 +1,132 @@
+#include "event_stream.hpp"
+#include "parser.hpp"
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+namespace OrderEngine {
+
+std::string formatEventJson(const MarketEvent& event, int price_decimals) {
+    std::ostringstream json;
+    if (event.type == EventType::CANCEL) {
+        json << "{\"type\":\"cancel\",\"id\":" << event.order_id << ",\"ts\":" << event.timestamp_ns << "}";
+    } else {
+        json << "{\"id\":" << event.order_id
+             << ",\"side\":\"" << (event.side == OrderSide::BUY ? "buy" : "sell") << "\""
+             << ",\"price\":" << std::fixed << std::setprecision(price_decimals) << event.price
+             << ",\"quantity\":" << event.quantity
+             << ",\"ts\":" << event.timestamp_ns << "}";
+    }
+    return json.str();
+}
+
+void writeBinaryHeader(std::ostream& out, const std::string& config_json) {
+    uint32_t header[3] = {kEventStreamMagic, kEventStreamVersion, static_cast<uint32_t>(config_json.size())};
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(config_json.data(), static_cast<std::streamsize>(config_json.size()));
+}
+
+void writeBinaryEvent(std::ostream& out, const MarketEvent& event) {
+    BinaryEventRecord record{
+        event.timestamp_ns,
+        event.order_id,
+        event.price,
+        event.quantity,
+        static_cast<uint8_t>(event.type),
+        static_cast<uint8_t>(event.side),
+        static_cast<uint8_t>(event.aggressive ? 1 : 0),
+        0
+    };
+    out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+}
+
+bool readBinaryHeader(std::istream& in, std::string& config_json) {
+    uint32_t header[3];
+    if (!in.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        header[0] != kEventStreamMagic || header[1] != kEventStreamVersion) {
+        return false;
+    }
+    config_json.resize(header[2]);
+    return static_cast<bool>(in.read(config_json.data(), header[2]));
+}
+
+bool readBinaryEvent(std::istream& in, MarketEvent& event) {
+    BinaryEventRecord record;
+    if (!in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        return false;
+    }
+    event.timestamp_ns = record.timestamp_ns;
+    event.order_id = record.order_id;
+    event.type = static_cast<EventType>(record.type);
+    event.side = static_cast<OrderSide>(record.side);
+    event.price = record.price;
+    event.quantity = record.quantity;
+    event.aggressive = record.aggressive != 0;
+    return true;
+}
+
+namespace {
+
+uint64_t parseTimestamp(const std::string& line) {
+    size_t pos = line.find("\"ts\":");
+    if (pos == std::string::npos) {
+        return 0;
+    }
+    return std::strtoull(line.c_str() + pos + 5, nullptr, 10);
+}
+
+} // namespace
+
+bool readEventStream(std::istream& in, std::vector<MarketEvent>& events,
+                     size_t& rejected_lines, std::string& error) {
+    rejected_lines = 0;
+    uint32_t magic = 0;
+    in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    in.clear();
+    in.seekg(0);
+    
+    if (magic == kEventStreamMagic) {
+        std::string config_json;
+        if (!readBinaryHeader(in, config_json)) {
+            error = "unsupported binary stream header";
+            return false;
+        }
+        MarketEvent event;
+        while (readBinaryEvent(in, event)) {
+            events.push_back(event);
+        }
+        if (in.gcount() != 0) {
+            error = "truncated binary record";
+            return false;
+        }
+        return true;
+    }
+    
+    OrderParser parser;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+        MarketEvent event{parseTimestamp(line), 0, EventType::NEW, OrderSide::BUY, 0.0, 0, false};
+        if (auto cancel_id = parser.parseCancel(line)) {
+            event.type = EventType::CANCEL;
+            event.order_id = *cancel_id;
+        } else if (auto order = parser.parseOrder(line)) {
+            event.order_id = (*order)->id;
+            event.side = (*order)->side;
+            event.price = (*order)->price;
+            event.quantity = (*order)->quantity;
+        } else {
+            rejected_lines++;
+            continue;
+        }
+        events.push_back(event);
+    }
+    return true;
+}
+
+} // namespace OrderEngine
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+#include <string>
+#include "market_generator.hpp"
+
+namespace OrderEngine {
+
+// JSON Lines in the order_engine wire protocol:
+//   {"id":7,"side":"buy","price":100.01,"quantity":10,"ts":1500}
+//   {"type":"cancel","id":7,"ts":2100}
+std::string formatEventJson(const MarketEvent& event, int price_decimals);
+
+// Binary stream: header (magic, version, config length, config JSON) followed
+// by fixed 32-byte little-endian records.
+constexpr uint32_t kEventStreamMagic = 0x444d454f;  // "OEMD"
+constexpr uint32_t kEventStreamVersion = 1;
+
+struct BinaryEventRecord {
+    uint64_t timestamp_ns;
+    uint64_t order_id;
+    double price;
+    uint32_t quantity;
+    uint8_t type;        // EventType
+    uint8_t side;        // OrderSide
+    uint8_t aggressive;
+    uint8_t reserved;
+};
+static_assert(sizeof(BinaryEventRecord) == 32, "binary event records are 32 bytes");
+
+void writeBinaryHeader(std::ostream& out, const std::string& config_json);
+void writeBinaryEvent(std::ostream& out, const MarketEvent& event);
+
+// Return false on a bad header or at the end of the stream
+bool readBinaryHeader(std::istream& in, std::string& config_json);
+bool readBinaryEvent(std::istream& in, MarketEvent& event);
+
+// Loads a recorded stream in either format, told apart by the binary magic.
+// JSON lines go through OrderParser exactly as the server parses them; lines it
+// rejects are skipped and counted, as the server would drop them.
+bool readEventStream(std::istream& in, std::vector<MarketEvent>& events,
+                     size_t& rejected_lines, std::string& error);
+
+} // namespace OrderEngine
@@ -0,0 +1,165 @@
+#include "market_generator.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <sstream>
+
+namespace OrderEngine {
+
+// Shortest text that parses back to the same double
+static std::string formatDouble(double value) {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    return std::string(buffer, result.ptr);
+}
+
+std::string GeneratorConfig::toJson() const {
+    std::ostringstream json;
+    json << "{\"seed\":" << seed
+         << ",\"arrival_rate\":" << formatDouble(arrival_rate)
+         << ",\"mid_price\":" << formatDouble(mid_price)
+         << ",\"tick_size\":" << formatDouble(tick_size)
+         << ",\"mean_reversion\":" << formatDouble(mean_reversion)
+         << ",\"volatility_ticks\":" << formatDouble(volatility_ticks)
+         << ",\"spread_ticks\":" << spread_ticks
+         << ",\"distance_alpha\":" << formatDouble(distance_alpha)
+         << ",\"max_distance_ticks\":" << max_distance_ticks
+         << ",\"cancel_ratio\":" << formatDouble(cancel_ratio)
+         << ",\"aggressive_ratio\":" << formatDouble(aggressive_ratio)
+         << ",\"max_sweep_ticks\":" << max_sweep_ticks
+         << ",\"mean_quantity\":" << formatDouble(mean_quantity)
+         << ",\"aggressive_quantity_factor\":" << formatDouble(aggressive_quantity_factor)
+         << ",\"cancel_window\":" << cancel_window
+         << ",\"first_order_id\":" << first_order_id
+         << "}";
+    return json.str();
+}
+
+bool GeneratorConfig::parseOption(const std::string& arg) {
+    if (arg.rfind("--", 0) != 0 || arg.find('=') == std::string::npos) {
+        return false;
+    }
+    std::string name = arg.substr(2, arg.find('=') - 2);
+    std::string value = arg.substr(arg.find('=') + 1);
+    if (name == "seed") seed = std::stoull(value);
+    else if (name == "arrival-rate") arrival_rate = std::stod(value);
+    else if (name == "mid-price") mid_price = std::stod(value);
+    else if (name == "tick-size") tick_size = std::stod(value);
+    else if (name == "mean-reversion") mean_reversion = std::stod(value);
+    else if (name == "volatility-ticks") volatility_ticks = std::stod(value);
+    else if (name == "spread-ticks") spread_ticks = std::stoi(value);
+    else if (name == "distance-alpha") distance_alpha = std::stod(value);
+    else if (name == "max-distance-ticks") max_distance_ticks = std::stoi(value);
+    else if (name == "cancel-ratio") cancel_ratio = std::stod(value);
+    else if (name == "aggressive-ratio") aggressive_ratio = std::stod(value);
+    else if (name == "max-sweep-ticks") max_sweep_ticks = std::stoi(value);
+    else if (name == "mean-quantity") mean_quantity = std::stod(value);
+    else if (name == "aggressive-quantity-factor") aggressive_quantity_factor = std::stod(value);
+    else if (name == "cancel-window") cancel_window = std::stoull(value);
+    else if (name == "first-order-id") first_order_id = std::stoull(value);
+    else return false;
+    return true;
+}
+
+const char* GeneratorConfig::optionsHelp() {
+    return "  --seed=N --arrival-rate=EVENTS_PER_SEC --mid-price=P --tick-size=T\n"
+           "  --mean-reversion=PER_SEC --volatility-ticks=TICKS --spread-ticks=N\n"
+           "  --distance-alpha=A --max-distance-ticks=N --cancel-ratio=F\n"
+           "  --aggressive-ratio=F --max-sweep-ticks=N --mean-quantity=Q\n"
+           "  --aggressive-quantity-factor=F --cancel-window=N --first-order-id=N\n";
+}
+
+int GeneratorConfig::priceDecimals() const {
+    int decimals = 0;
+    double scaled = tick_size;
+    while (decimals < 9 && std::fabs(scaled - std::round(scaled)) > 1e-9) {
+        scaled *= 10.0;
+        decimals++;
+    }
+    return decimals;
+}
+
+MarketGenerator::MarketGenerator(const GeneratorConfig& config)
+    : config_(config),
+      rng_(config.seed),
+      ticks_per_unit_(std::round(1.0 / config.tick_size)),
+      mid_ticks_(config.mid_price * std::round(1.0 / config.tick_size)),
+      next_order_id_(config.first_order_id) {}
+
+double MarketGenerator::uniform() {
+    // 53 random bits in (0, 1)
+    return (static_cast<double>(rng_() >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+double MarketGenerator::exponential(double rate) {
+    return -std::log(uniform()) / rate;
+}
+
+double MarketGenerator::normal() {
+    // Box-Muller, one value per call
+    constexpr double kTwoPi = 6.283185307179586;
+    return std::sqrt(-2.0 * std::log(uniform())) * std::cos(kTwoPi * uniform());
+}
+
+uint32_t MarketGenerator::geometric(double mean) {
+    if (mean <= 1.0) {
+        return 1;
+    }
+    double p = 1.0 / mean;
+    return 1 + static_cast<uint32_t>(std::floor(std::log(uniform()) / std::log(1.0 - p)));
+}
+
+int MarketGenerator::powerLawDistance() {
+    // Pareto(x_min = 1): P(X > x) = x^-alpha, shifted so the touch itself is distance 0
+    // A small alpha makes x too big for an int, so clamp before converting
+    double x = std::pow(uniform(), -1.0 / config_.distance_alpha);
+    return static_cast<int>(std::min(x - 1, static_cast<double>(config_.max_distance_ticks)));
+}
+
+void MarketGenerator::advanceMid(double dt_s) {
+    double target = config_.mid_price * ticks_per_unit_;
+    mid_ticks_ += config_.mean_reversion * (target - mid_ticks_) * dt_s +
+                  config_.volatility_ticks * std::sqrt(dt_s) * normal();
+}
+
+MarketEvent MarketGenerator::next() {
+    double dt_s = exponential(config_.arrival_rate);
+    now_s_ += dt_s;
+    advanceMid(dt_s);
+    
+    MarketEvent event{};
+    event.timestamp_ns = static_cast<uint64_t>(now_s_ * 1e9);
+    
+    if (!live_orders_.empty() && uniform() < config_.cancel_ratio) {
+        size_t window = std::min(config_.cancel_window, live_orders_.size());
+        size_t index = live_orders_.size() - 1 - static_cast<size_t>(uniform() * window);
+        event.type = EventType::CANCEL;
+        event.order_id = live_orders_[index];
+        live_orders_.erase(live_orders_.begin() + static_cast<std::ptrdiff_t>(index));
+        return event;
+    }
+    
+    event.type = EventType::NEW;
+    event.order_id = next_order_id_++;
+    event.side = uniform() < 0.5 ? OrderSide::BUY : OrderSide::SELL;
+    
+    int64_t bid_touch = static_cast<int64_t>(std::floor(mid_ticks_ - config_.spread_ticks / 2.0));
+    int64_t ask_touch = bid_touch + config_.spread_ticks;
+    int64_t ticks;
+    event.aggressive = uniform() < config_.aggressive_ratio;
+    if (event.aggressive) {
+        // Marketable limit sweeping up to max_sweep_ticks into the opposite side
+        int sweep = static_cast<int>(uniform() * (config_.max_sweep_ticks + 1));
+        ticks = event.side == OrderSide::BUY ? ask_touch + sweep : bid_touch - sweep;
+        event.quantity = geometric(config_.mean_quantity * config_.aggressive_quantity_factor);
+    } else {
+        int distance = powerLawDistance();
+        ticks = event.side == OrderSide::BUY ? bid_touch - distance : ask_touch + distance;
+        event.quantity = geometric(config_.mean_quantity);
+        live_orders_.push_back(event.order_id);
+    }
+    event.price = priceOf(std::max<int64_t>(ticks, 1));
+    return event;
+}
+
+} // namespace OrderEngine
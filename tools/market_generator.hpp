@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "order_book.hpp"
+
+namespace OrderEngine {
+
+enum class EventType : uint8_t { NEW, CANCEL };
+
+struct MarketEvent {
+    uint64_t timestamp_ns;  // Offset from the start of the stream
+    uint64_t order_id;      // New order id, or the id being cancelled
+    EventType type;
+    OrderSide side;
+    double price;
+    uint32_t quantity;
+    bool aggressive;        // New order priced through the touch
+};
+
+// Every parameter that shapes the stream; two runs with equal configs
+// produce identical events on the same platform. The draws go through libm's
+// log, cos and pow, whose last bit may differ on another one.
+struct GeneratorConfig {
+    uint64_t seed = 1;
+    double arrival_rate = 100000.0;   // Poisson arrivals per second
+    double mid_price = 100.0;
+    double tick_size = 0.01;
+    double mean_reversion = 2.0;      // Ornstein-Uhlenbeck pull towards mid_price, per second
+    double volatility_ticks = 50.0;   // Mid diffusion, ticks per sqrt(second)
+    int spread_ticks = 2;
+    double distance_alpha = 2.5;      // Power-law exponent of passive distance from the touch
+    int max_distance_ticks = 1000;
+    double cancel_ratio = 0.45;       // Share of events that cancel a live order (~0.48 is break-even)
+    double aggressive_ratio = 0.05;   // Share of new orders that sweep through the touch
+    int max_sweep_ticks = 10;
+    double mean_quantity = 100.0;
+    double aggressive_quantity_factor = 5.0;
+    size_t cancel_window = 1000;      // Cancels pick among this many most recent live orders
+    uint64_t first_order_id = 1;
+    
+    std::string toJson() const;
+    int priceDecimals() const;
+    
+    // Applies a --name=value option (e.g. --seed=7, --cancel-ratio=0.9);
+    // returns false if arg is not a generator option
+    bool parseOption(const std::string& arg);
+    static const char* optionsHelp();
+};
+
+class MarketGenerator {
+public:
+    explicit MarketGenerator(const GeneratorConfig& config);
+    
+    MarketEvent next();
+    
+    const GeneratorConfig& config() const { return config_; }
+    double midPrice() const { return mid_ticks_ / ticks_per_unit_; }
+    
+private:
+    GeneratorConfig config_;
+    std::mt19937_64 rng_;
+    double ticks_per_unit_;
+    double mid_ticks_;
+    double now_s_{0.0};
+    uint64_t next_order_id_;
+    std::vector<uint64_t> live_orders_;  // Ids this generator placed, oldest first
+    
+    // Distribution transforms written out so streams do not depend on the
+    // standard library's distribution algorithms
+    double uniform();
+    double exponential(double rate);
+    double normal();
+    uint32_t geometric(double mean);
+    int powerLawDistance();
+    
+    void advanceMid(double dt_s);
+    double priceOf(int64_t ticks) const { return static_cast<double>(ticks) / ticks_per_unit_; }
+};
+
+} // namespace OrderEngine
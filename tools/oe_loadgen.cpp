@@ -0,0 +1,356 @@
+// Open-loop TCP load client for order_engine.
+//
+// Every connection sends on a fixed schedule whether or not the server keeps
+// up, and each round trip is timed from the *intended* send time to the ack.
+// A stalled server therefore shows up as queueing delay in the histogram
+// instead of silently slowing the client down (coordinated omission).
+//
+//   oe_loadgen --connect=HOST:PORT [--connections=N] [--rates=R1,R2,...]
+//              [--start-rate=R --max-rate=R --rate-factor=F]
+//              [--duration-ms=N] [--warmup-ms=N] [--drain-ms=N] [--no-stop]
+//              [--format=table|json] [--out=FILE] [generator options]
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cerrno>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "histogram.hpp"
+#include "bench_report.hpp"
+#include "market_generator.hpp"
+#include "event_stream.hpp"
+#include "tcp_client.hpp"
+
+using namespace OrderEngine;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    GeneratorConfig config;
+    std::string connect;
+    int connections = 4;
+    std::vector<double> rates;  // Explicit offered rates (msgs/sec, all connections)
+    double start_rate = 1000;
+    double max_rate = 1000000;
+    double rate_factor = 2.0;
+    uint64_t duration_ms = 2000;
+    uint64_t warmup_ms = 500;
+    uint64_t drain_ms = 1000;
+    bool stop_at_saturation = true;
+    BenchOutputOptions output;
+};
+
+struct InFlight {
+    uint64_t id;
+    Clock::time_point intended;
+    bool measured;  // False for warmup sends
+};
+
+struct Connection {
+    int fd = -1;
+    std::unique_ptr<MarketGenerator> generator;
+    Clock::time_point next_send;
+    std::string outbox;
+    std::string inbox;
+    std::deque<InFlight> in_flight;  // Server acks in request order
+};
+
+struct StepResult {
+    uint64_t sent = 0;
+    uint64_t acked = 0;
+    uint64_t acked_in_window = 0;  // Acks received before sending stopped
+    uint64_t lost = 0;             // Requests the server never acked (e.g. rejected)
+    uint64_t outstanding = 0;      // Still unacked after the drain period
+    LatencyHistogram latency;
+    Clock::time_point window_end;
+};
+
+// Acks look like "ACK: Order received id=42"; anything else is ignored
+bool parseAckId(const std::string& line, uint64_t& id) {
+    size_t pos = line.rfind("id=");
+    if (line.rfind("ACK:", 0) != 0 || pos == std::string::npos) {
+        return false;
+    }
+    try {
+        id = std::stoull(line.substr(pos + 3));
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+bool flushOutbox(Connection& conn) {
+    while (!conn.outbox.empty()) {
+        ssize_t n = send(conn.fd, conn.outbox.data(), conn.outbox.size(), MSG_NOSIGNAL);
+        if (n > 0) {
+            conn.outbox.erase(0, static_cast<size_t>(n));
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;  // Kernel buffer full: the schedule keeps running regardless
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool readAcks(Connection& conn, Clock::time_point now, StepResult& result) {
+    char buffer[16384];
+    while (true) {
+        ssize_t n = recv(conn.fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            conn.inbox.append(buffer, static_cast<size_t>(n));
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return false;
+        }
+    }
+
+    size_t line_start = 0;
+    size_t newline;
+    while ((newline = conn.inbox.find('\n', line_start)) != std::string::npos) {
+        uint64_t id;
+        bool is_ack = parseAckId(conn.inbox.substr(line_start, newline - line_start), id);
+        line_start = newline + 1;
+        if (!is_ack) {
+            continue;
+        }
+        // Requests the server dropped without an ack are skipped over
+        while (!conn.in_flight.empty() && conn.in_flight.front().id != id) {
+            result.lost += conn.in_flight.front().measured;
+            conn.in_flight.pop_front();
+        }
+        if (conn.in_flight.empty()) {
+            continue;
+        }
+        const InFlight& request = conn.in_flight.front();
+        if (request.measured) {
+            auto rtt = std::chrono::duration_cast<std::chrono::nanoseconds>(now - request.intended);
+            result.latency.record(static_cast<uint64_t>(rtt.count()));
+            result.acked++;
+            result.acked_in_window += now <= result.window_end;
+        }
+        conn.in_flight.pop_front();
+    }
+    conn.inbox.erase(0, line_start);
+    return true;
+}
+
+// Runs one offered rate: warmup, a measured window, then a drain period for
+// late acks. Returns false if a connection fails.
+bool runStep(std::vector<Connection>& conns, double rate, const Options& options,
+             int price_decimals, StepResult& result) {
+    auto interval = std::chrono::nanoseconds(
+        static_cast<int64_t>(1e9 * conns.size() / rate));
+    auto start = Clock::now();
+    auto measure_from = start + std::chrono::milliseconds(options.warmup_ms);
+    auto send_until = measure_from + std::chrono::milliseconds(options.duration_ms);
+    result.window_end = send_until;
+    auto drain_until = send_until + std::chrono::milliseconds(options.drain_ms);
+
+    // Stagger connections across one interval so sends do not arrive in bursts
+    for (size_t i = 0; i < conns.size(); ++i) {
+        conns[i].next_send = start + interval * i / conns.size();
+    }
+
+    std::vector<pollfd> fds(conns.size());
+    while (true) {
+        auto now = Clock::now();
+        bool sending = now < send_until;
+        bool pending = false;
+        Clock::time_point next_due = send_until;
+        for (auto& conn : conns) {
+            while (sending && conn.next_send <= now) {
+                MarketEvent event = conn.generator->next();
+                conn.outbox += formatEventJson(event, price_decimals);
+                conn.outbox += '\n';
+                bool measured = conn.next_send >= measure_from;
+                conn.in_flight.push_back({event.order_id, conn.next_send, measured});
+                result.sent += measured;
+                conn.next_send += interval;
+            }
+            if (!flushOutbox(conn)) {
+                std::cerr << "Send failed\n";
+                return false;
+            }
+            next_due = std::min(next_due, conn.next_send);
+            pending |= !conn.in_flight.empty();
+        }
+        if (!sending && (!pending || now >= drain_until)) {
+            break;
+        }
+
+        // Sleep in poll only while the next send is comfortably far away
+        int timeout_ms = !sending || next_due - now > std::chrono::milliseconds(2) ? 1 : 0;
+        for (size_t i = 0; i < conns.size(); ++i) {
+            fds[i] = {conns[i].fd, static_cast<short>(POLLIN | (conns[i].outbox.empty() ? 0 : POLLOUT)), 0};
+        }
+        if (poll(fds.data(), fds.size(), timeout_ms) < 0 && errno != EINTR) {
+            return false;
+        }
+        now = Clock::now();
+        for (size_t i = 0; i < conns.size(); ++i) {
+            if ((fds[i].revents & (POLLIN | POLLHUP | POLLERR)) && !readAcks(conns[i], now, result)) {
+                std::cerr << "Connection " << i << " closed by server\n";
+                return false;
+            }
+        }
+    }
+
+    for (auto& conn : conns) {
+        for (const auto& request : conn.in_flight) {
+            result.outstanding += request.measured;
+        }
+        // Unacked requests would otherwise be charged to the next step
+        for (auto& request : conn.in_flight) {
+            request.measured = false;
+        }
+    }
+    return true;
+}
+
+std::vector<double> parseRates(const std::string& list) {
+    std::vector<double> rates;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        rates.push_back(std::stod(item));
+    }
+    return rates;
+}
+
+void printUsage(const char* argv0) {
+    std::cerr << "Usage: " << argv0 << " --connect=HOST:PORT [options]\n"
+              << "  --connections=N --rates=R1,R2,... | --start-rate=R --max-rate=R --rate-factor=F\n"
+              << "  --duration-ms=N --warmup-ms=N --drain-ms=N --no-stop\n"
+              << "  --format=table|json --out=FILE\n"
+              << GeneratorConfig::optionsHelp();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (options.output.parse(arg) || options.config.parseOption(arg)) {
+                continue;
+            } else if (arg.rfind("--connect=", 0) == 0) {
+                options.connect = arg.substr(10);
+            } else if (arg.rfind("--connections=", 0) == 0) {
+                options.connections = std::stoi(arg.substr(14));
+            } else if (arg.rfind("--rates=", 0) == 0) {
+                options.rates = parseRates(arg.substr(8));
+            } else if (arg.rfind("--start-rate=", 0) == 0) {
+                options.start_rate = std::stod(arg.substr(13));
+            } else if (arg.rfind("--max-rate=", 0) == 0) {
+                options.max_rate = std::stod(arg.substr(11));
+            } else if (arg.rfind("--rate-factor=", 0) == 0) {
+                options.rate_factor = std::stod(arg.substr(14));
+            } else if (arg.rfind("--duration-ms=", 0) == 0) {
+                options.duration_ms = std::stoull(arg.substr(14));
+            } else if (arg.rfind("--warmup-ms=", 0) == 0) {
+                options.warmup_ms = std::stoull(arg.substr(12));
+            } else if (arg.rfind("--drain-ms=", 0) == 0) {
+                options.drain_ms = std::stoull(arg.substr(11));
+            } else if (arg == "--no-stop") {
+                options.stop_at_saturation = false;
+            } else {
+                printUsage(argv[0]);
+                return 2;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid option: " << e.what() << "\n";
+        return 2;
+    }
+    if (options.connect.empty() || options.connections < 1 || options.rate_factor <= 1.0) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    if (options.rates.empty()) {
+        for (double rate = options.start_rate; rate <= options.max_rate; rate *= options.rate_factor) {
+            options.rates.push_back(rate);
+        }
+    }
+
+    std::vector<Connection> conns(options.connections);
+    for (int i = 0; i < options.connections; ++i) {
+        auto& conn = conns[i];
+        conn.fd = connectTo(options.connect);
+        if (conn.fd < 0) {
+            return 1;
+        }
+        int one = 1;
+        setsockopt(conn.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        fcntl(conn.fd, F_SETFL, fcntl(conn.fd, F_GETFL) | O_NONBLOCK);
+        // Disjoint id ranges per connection so cancels only target their own orders
+        GeneratorConfig config = options.config;
+        config.seed = options.config.seed + i;
+        config.first_order_id = (static_cast<uint64_t>(i) + 1) << 40;
+        conn.generator = std::make_unique<MarketGenerator>(config);
+    }
+    std::cerr << "Generator config: " << options.config.toJson() << "\n";
+
+    BenchReporter reporter;
+    int price_decimals = options.config.priceDecimals();
+    bool failed = false;
+    for (double rate : options.rates) {
+        StepResult result;
+        if (!runStep(conns, rate, options, price_decimals, result)) {
+            failed = true;
+            break;
+        }
+
+        double window_s = options.duration_ms / 1000.0;
+        double sent_rate = result.sent / window_s;
+        // Throughput only counts acks that kept pace; a backlog drained afterwards does not
+        double acked_rate = result.acked_in_window / window_s;
+        bool saturated = result.outstanding > 0 || sent_rate < 0.95 * rate || acked_rate < 0.95 * rate;
+
+        BenchResult bench;
+        bench.suite = "loadgen";
+        bench.name = "tcp_rtt";
+        bench.params = {{"connections", std::to_string(options.connections)},
+                        {"offered", std::to_string(static_cast<uint64_t>(rate))}};
+        bench.ops = result.acked;
+        bench.total_ns = options.duration_ms * 1000000;
+        bench.setPercentiles(result.latency);
+        bench.extra = {{"offered_per_sec", rate},
+                       {"sent_per_sec", sent_rate},
+                       {"acked_per_sec", acked_rate},
+                       {"lost", static_cast<double>(result.lost)},
+                       {"outstanding", static_cast<double>(result.outstanding)},
+                       {"saturated", saturated ? 1.0 : 0.0}};
+        reporter.add(bench);
+
+        std::cerr << std::fixed << std::setprecision(0)
+                  << "offered " << rate << "/s: sent " << sent_rate << "/s, acked "
+                  << acked_rate << "/s, p99 " << result.latency.getPercentile(99.0) / 1000.0
+                  << "µs, lost " << result.lost << ", outstanding " << result.outstanding
+                  << (saturated ? "  [saturated]" : "") << "\n";
+        if (saturated && options.stop_at_saturation) {
+            break;
+        }
+    }
+
+    for (auto& conn : conns) {
+        close(conn.fd);
+    }
+    if (!options.output.write(reporter)) {
+        return 1;
+    }
+    return failed ? 1 : 0;
+}
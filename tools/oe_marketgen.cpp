@@ -0,0 +1,223 @@
+// Seeded synthetic market flow: Poisson arrivals, a mean-reverting mid,
+// power-law distances from the touch, cancel-heavy mix and aggressive sweeps.
+//
+//   oe_marketgen [generator options] --events=N                  drive OrderBook in-process
+//   oe_marketgen ... --out=FILE [--format=json|binary]           write a stream (+ FILE.config.json)
+//   oe_marketgen ... --connect=HOST:PORT                         send JSON lines to order_engine
+//   [--pace=realtime|max] [--config-out=FILE]
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cerrno>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "order_book.hpp"
+#include "market_generator.hpp"
+#include "event_stream.hpp"
+#include "tcp_client.hpp"
+
+using namespace OrderEngine;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    GeneratorConfig config;
+    uint64_t events = 1000000;
+    std::string out_path;
+    bool binary = false;
+    std::string connect;
+    bool realtime = false;
+    bool pace_set = false;
+    std::string config_out;
+};
+
+void paceUntil(Clock::time_point start, uint64_t timestamp_ns) {
+    auto due = start + std::chrono::nanoseconds(timestamp_ns);
+    while (Clock::now() < due) {
+        if (due - Clock::now() > std::chrono::microseconds(200)) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+}
+
+int runInProcess(const Options& options) {
+    MarketGenerator generator(options.config);
+    std::vector<MarketEvent> events;
+    std::vector<std::unique_ptr<Order>> orders;
+    events.reserve(options.events);
+    orders.reserve(options.events);
+    uint64_t aggressive = 0;
+    for (uint64_t i = 0; i < options.events; ++i) {
+        events.push_back(generator.next());
+        const auto& event = events.back();
+        aggressive += event.aggressive;
+        orders.push_back(event.type == EventType::NEW
+            ? std::make_unique<Order>(event.order_id, event.side, event.price, event.quantity)
+            : nullptr);
+    }
+    
+    OrderBook order_book;
+    uint64_t trades = 0;
+    uint64_t volume = 0;
+    order_book.setTradeCallback([&](const Trade& trade) {
+        trades++;
+        volume += trade.quantity;
+    });
+    
+    uint64_t cancels = 0;
+    uint64_t cancels_hit = 0;
+    auto start = Clock::now();
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (orders[i]) {
+            order_book.processOrderSync(std::move(orders[i]));
+        } else {
+            cancels++;
+            cancels_hit += order_book.cancelOrderSync(events[i].order_id);
+        }
+    }
+    double elapsed_s = std::chrono::duration<double>(Clock::now() - start).count();
+    
+    const auto& stats = order_book.getLatencyStats();
+    std::cout << "=== IN-PROCESS RUN ===\n"
+              << "Events: " << events.size() << " (" << events.size() - cancels << " new, "
+              << aggressive << " aggressive, " << cancels << " cancels, "
+              << cancels_hit << " hit a live order)\n"
+              << "Trades: " << trades << " | volume " << volume << "\n"
+              << "Final book: " << order_book.getBuyOrdersCount() << " bids, "
+              << order_book.getSellOrdersCount() << " asks\n"
+              << "Elapsed: " << elapsed_s << "s | " << events.size() / elapsed_s << " events/sec\n"
+              << "Order latency: avg " << stats.getAverageLatencyUs() << "µs, max "
+              << stats.getMaxLatencyUs() << "µs\n";
+    return 0;
+}
+
+int writeFile(const Options& options) {
+    std::ofstream out(options.out_path, std::ios::binary);
+    if (!out) {
+        std::cerr << "Cannot open " << options.out_path << "\n";
+        return 1;
+    }
+    MarketGenerator generator(options.config);
+    std::string config_json = options.config.toJson();
+    int decimals = options.config.priceDecimals();
+    if (options.binary) {
+        writeBinaryHeader(out, config_json);
+    }
+    
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < options.events; ++i) {
+        MarketEvent event = generator.next();
+        if (options.realtime) {
+            paceUntil(start, event.timestamp_ns);
+        }
+        if (options.binary) {
+            writeBinaryEvent(out, event);
+        } else {
+            out << formatEventJson(event, decimals) << "\n";
+        }
+    }
+    
+    std::ofstream sidecar(options.out_path + ".config.json");
+    sidecar << config_json << "\n";
+    std::cout << "Wrote " << options.events << " events to " << options.out_path << "\n";
+    return out ? 0 : 1;
+}
+
+int sendToSocket(const Options& options) {
+    int fd = connectTo(options.connect);
+    if (fd < 0) {
+        return 1;
+    }
+    // Acks are drained and discarded so the server never blocks on a full socket
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    char discard[4096];
+    
+    MarketGenerator generator(options.config);
+    int decimals = options.config.priceDecimals();
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < options.events; ++i) {
+        MarketEvent event = generator.next();
+        if (options.realtime) {
+            paceUntil(start, event.timestamp_ns);
+        }
+        std::string line = formatEventJson(event, decimals) + "\n";
+        size_t sent = 0;
+        while (sent < line.size()) {
+            ssize_t n = send(fd, line.data() + sent, line.size() - sent, MSG_NOSIGNAL);
+            if (n > 0) {
+                sent += static_cast<size_t>(n);
+            } else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::cerr << "Send failed after " << i << " events\n";
+                close(fd);
+                return 1;
+            }
+            while (recv(fd, discard, sizeof(discard), 0) > 0) {}
+        }
+    }
+    double elapsed_s = std::chrono::duration<double>(Clock::now() - start).count();
+    close(fd);
+    std::cout << "Sent " << options.events << " events in " << elapsed_s << "s ("
+              << options.events / elapsed_s << " events/sec)\n";
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (options.config.parseOption(arg)) {
+                continue;
+            } else if (arg.rfind("--events=", 0) == 0) {
+                options.events = std::stoull(arg.substr(9));
+            } else if (arg.rfind("--out=", 0) == 0) {
+                options.out_path = arg.substr(6);
+            } else if (arg == "--format=binary" || arg == "--format=json") {
+                options.binary = arg == "--format=binary";
+            } else if (arg.rfind("--connect=", 0) == 0) {
+                options.connect = arg.substr(10);
+            } else if (arg == "--pace=realtime" || arg == "--pace=max") {
+                options.realtime = arg == "--pace=realtime";
+                options.pace_set = true;
+            } else if (arg.rfind("--config-out=", 0) == 0) {
+                options.config_out = arg.substr(13);
+            } else {
+                std::cerr << "Usage: " << argv[0] << " [options]\n"
+                          << "  --events=N --out=FILE --format=json|binary --connect=HOST:PORT\n"
+                          << "  --pace=realtime|max --config-out=FILE\n"
+                          << GeneratorConfig::optionsHelp();
+                return 2;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid option: " << e.what() << "\n";
+        return 2;
+    }
+    
+    // Sockets are paced at the arrival rate by default, files and in-process runs go flat out
+    if (!options.pace_set) {
+        options.realtime = !options.connect.empty();
+    }
+    
+    std::cerr << "Generator config: " << options.config.toJson() << "\n";
+    if (!options.config_out.empty()) {
+        std::ofstream(options.config_out) << options.config.toJson() << "\n";
+    }
+    
+    if (!options.connect.empty()) {
+        return sendToSocket(options);
+    }
+    if (!options.out_path.empty()) {
+        return writeFile(options);
+    }
+    return runInProcess(options);
+}
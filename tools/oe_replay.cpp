@@ -0,0 +1,255 @@
+// Deterministic replay of a recorded order stream (JSON lines or the binary
+// format written by oe_marketgen) through OrderBook's synchronous path.
+// Produces a canonical text stream of everything the book did, which can be
+// written out as a golden file and later checked byte-for-byte, so engine
+// changes can be verified against current behaviour while timing the run.
+//
+//   oe_replay INPUT [--pace=max|recorded] [--output=FILE] [--golden=FILE]
+//             [--snapshot-every=N] [--snapshot-depth=N] [--format=table|json] [--out=FILE]
+//
+// Canonical output (v1), one record per line; prices in shortest round-trip form:
+//   T <seq> <buy_id> <sell_id> <price> <quantity>   trade caused by event <seq>
+//   C <seq> <id> <0|1>                              cancel, and whether it hit a live order
+//   S <seq> <bid_orders> <ask_orders>               snapshot after event <seq>, followed by
+//   B <price> <quantity> <orders>                   bid levels from the touch, then
+//   A <price> <quantity> <orders>                   ask levels (all levels in the final snapshot)
+#include <charconv>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+#include "order_book.hpp"
+#include "bench_report.hpp"
+#include "event_stream.hpp"
+
+using namespace OrderEngine;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string input;
+    bool recorded_pace = false;
+    std::string output_path;
+    std::string golden_path;
+    size_t snapshot_every = 1000;
+    size_t snapshot_depth = 5;
+    BenchOutputOptions report;
+};
+
+// OrderParser logs every order it parses; the load discards that
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+void appendPrice(std::string& out, double price) {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), price);
+    out.append(buffer, result.ptr);
+}
+
+void appendSnapshot(std::string& out, const OrderBook& book, size_t seq, size_t depth) {
+    out += "S " + std::to_string(seq) + " " + std::to_string(book.getBuyOrdersCount()) + " " +
+           std::to_string(book.getSellOrdersCount()) + "\n";
+    for (OrderSide side : {OrderSide::BUY, OrderSide::SELL}) {
+        for (const auto& level : book.getDepth(side, depth)) {
+            out += side == OrderSide::BUY ? "B " : "A ";
+            appendPrice(out, level.price);
+            out += " " + std::to_string(level.quantity) + " " + std::to_string(level.orders) + "\n";
+        }
+    }
+}
+
+void paceUntil(Clock::time_point start, uint64_t timestamp_ns) {
+    auto due = start + std::chrono::nanoseconds(timestamp_ns);
+    while (Clock::now() < due) {
+        if (due - Clock::now() > std::chrono::microseconds(200)) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+}
+
+// Reports the first differing line; true if the files are identical
+bool compareWithGolden(const std::string& output, const std::string& golden_path) {
+    std::ifstream golden_file(golden_path, std::ios::binary);
+    if (!golden_file) {
+        std::cerr << "Cannot open golden file " << golden_path << "\n";
+        return false;
+    }
+    std::string golden((std::istreambuf_iterator<char>(golden_file)), std::istreambuf_iterator<char>());
+    if (output == golden) {
+        return true;
+    }
+
+    std::istringstream actual_lines(output);
+    std::istringstream golden_lines(golden);
+    std::string actual_line, golden_line;
+    for (size_t line = 1; ; ++line) {
+        bool has_actual = static_cast<bool>(std::getline(actual_lines, actual_line));
+        bool has_golden = static_cast<bool>(std::getline(golden_lines, golden_line));
+        if (!has_actual || !has_golden || actual_line != golden_line) {
+            std::cerr << "Output differs from " << golden_path << " at line " << line << "\n"
+                      << "  golden: " << (has_golden ? golden_line : "<end of file>") << "\n"
+                      << "  actual: " << (has_actual ? actual_line : "<end of output>") << "\n";
+            return false;
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (options.report.parse(arg)) {
+                continue;
+            } else if (arg == "--pace=max" || arg == "--pace=recorded") {
+                options.recorded_pace = arg == "--pace=recorded";
+            } else if (arg.rfind("--output=", 0) == 0) {
+                options.output_path = arg.substr(9);
+            } else if (arg.rfind("--golden=", 0) == 0) {
+                options.golden_path = arg.substr(9);
+            } else if (arg.rfind("--snapshot-every=", 0) == 0) {
+                options.snapshot_every = std::stoull(arg.substr(17));
+            } else if (arg.rfind("--snapshot-depth=", 0) == 0) {
+                options.snapshot_depth = std::stoull(arg.substr(17));
+            } else if (arg.rfind("--", 0) != 0 && options.input.empty()) {
+                options.input = arg;
+            } else {
+                throw std::invalid_argument(arg);
+            }
+        }
+    } catch (const std::exception&) {
+        options.input.clear();
+    }
+    if (options.input.empty()) {
+        std::cerr << "Usage: " << argv[0] << " INPUT [--pace=max|recorded] [--output=FILE] [--golden=FILE]\n"
+                  << "  [--snapshot-every=N] [--snapshot-depth=N] [--format=table|json] [--out=FILE]\n";
+        return 2;
+    }
+
+    std::ifstream in(options.input, std::ios::binary);
+    if (!in) {
+        std::cerr << "Cannot open " << options.input << "\n";
+        return 2;
+    }
+    std::vector<MarketEvent> events;
+    size_t rejected = 0;
+    std::string error;
+    NullBuffer null_buffer;
+    auto* console = std::cout.rdbuf(&null_buffer);
+    auto* errors = std::cerr.rdbuf(&null_buffer);
+    bool loaded = readEventStream(in, events, rejected, error);
+    std::cout.rdbuf(console);
+    std::cerr.rdbuf(errors);
+    if (!loaded) {
+        std::cerr << options.input << ": " << error << "\n";
+        return 2;
+    }
+
+    // Everything is built before the clock starts; only the engine calls are timed
+    std::vector<std::unique_ptr<Order>> orders(events.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        const auto& event = events[i];
+        if (event.type == EventType::NEW) {
+            orders[i] = std::make_unique<Order>(event.order_id, event.side, event.price, event.quantity);
+        }
+    }
+
+    struct SeqTrade {
+        size_t seq;
+        Trade trade;
+    };
+    std::vector<SeqTrade> trades;
+    trades.reserve(events.size());
+    size_t seq = 0;
+    OrderBook book;
+    book.setTradeCallback([&](const Trade& trade) { trades.push_back({seq, trade}); });
+
+    std::string output = "# oe_replay canonical v1\n";
+    std::vector<bool> cancel_hits(events.size());
+    LatencyHistogram latencies;
+    uint64_t engine_ns = 0;
+    size_t trades_written = 0;
+    auto start = Clock::now();
+    for (seq = 0; seq < events.size(); ++seq) {
+        if (options.recorded_pace) {
+            paceUntil(start, events[seq].timestamp_ns);
+        }
+
+        auto event_start = Clock::now();
+        if (orders[seq]) {
+            book.processOrderSync(std::move(orders[seq]));
+        } else {
+            cancel_hits[seq] = book.cancelOrderSync(events[seq].order_id);
+        }
+        uint64_t ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - event_start).count());
+        latencies.record(ns);
+        engine_ns += ns;
+
+        // Formatting is off the clock
+        for (; trades_written < trades.size(); ++trades_written) {
+            const Trade& trade = trades[trades_written].trade;
+            output += "T " + std::to_string(seq) + " " + std::to_string(trade.buy_order_id) + " " +
+                      std::to_string(trade.sell_order_id) + " ";
+            appendPrice(output, trade.price);
+            output += " " + std::to_string(trade.quantity) + "\n";
+        }
+        if (events[seq].type == EventType::CANCEL) {
+            output += "C " + std::to_string(seq) + " " + std::to_string(events[seq].order_id) +
+                      (cancel_hits[seq] ? " 1\n" : " 0\n");
+        }
+        if (options.snapshot_every > 0 && (seq + 1) % options.snapshot_every == 0) {
+            appendSnapshot(output, book, seq, options.snapshot_depth);
+        }
+    }
+    double wall_s = std::chrono::duration<double>(Clock::now() - start).count();
+    if (!events.empty()) {
+        appendSnapshot(output, book, events.size() - 1, 0);
+    }
+
+    std::cerr << "Replayed " << events.size() << " events (" << rejected << " rejected lines skipped), "
+              << trades.size() << " trades in " << wall_s << "s\n";
+
+    BenchResult result;
+    result.suite = "replay";
+    result.name = options.recorded_pace ? "replay_recorded" : "replay_max";
+    result.params = {{"input", options.input.substr(options.input.find_last_of('/') + 1)}};
+    result.ops = events.size();
+    result.total_ns = engine_ns;
+    result.setPercentiles(latencies);
+    result.extra = {{"trades", static_cast<double>(trades.size())},
+                    {"wall_events_per_sec", wall_s > 0 ? events.size() / wall_s : 0.0}};
+    BenchReporter reporter;
+    reporter.add(std::move(result));
+    if (!options.report.write(reporter)) {
+        return 1;
+    }
+
+    if (!options.output_path.empty()) {
+        std::ofstream out(options.output_path, std::ios::binary);
+        out << output;
+        if (!out) {
+            std::cerr << "Cannot write " << options.output_path << "\n";
+            return 1;
+        }
+    }
+    if (!options.golden_path.empty()) {
+        if (!compareWithGolden(output, options.golden_path)) {
+            return 1;
+        }
+        std::cerr << "Output matches " << options.golden_path << "\n";
+    }
+    return 0;
+}
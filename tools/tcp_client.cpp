@@ -0,0 +1,41 @@
+#include "tcp_client.hpp"
+#include <iostream>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace OrderEngine {
+
+int connectTo(const std::string& target) {
+    size_t colon = target.rfind(':');
+    if (colon == std::string::npos) {
+        std::cerr << "Expected HOST:PORT, got " << target << "\n";
+        return -1;
+    }
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(target.substr(0, colon).c_str(), target.substr(colon + 1).c_str(), &hints, &result) != 0) {
+        std::cerr << "Cannot resolve " << target << "\n";
+        return -1;
+    }
+    int fd = -1;
+    for (addrinfo* ai = result; ai; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd >= 0 && connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+            break;
+        }
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(result);
+    if (fd < 0) {
+        std::cerr << "Cannot connect to " << target << "\n";
+    }
+    return fd;
+}
+
+} // namespace OrderEngine
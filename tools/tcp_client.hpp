@@ -0,0 +1,11 @@
+#pragma once
+
+#include <string>
+
+namespace OrderEngine {
+
+// Opens a blocking TCP connection to "HOST:PORT"; returns the socket or -1
+// after printing the reason to stderr.
+int connectTo(const std::string& target);
+
+} // namespace OrderEngine